@@ -0,0 +1,30 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Bump allocator over a caller-supplied (usually static) buffer. Nothing
+// is freed individually; arena_reset() releases everything at once, so a
+// work cycle that allocates from an arena never fragments the heap.
+
+#define ARENA_ALIGN 8
+
+typedef struct {
+    uint8_t *base;
+    size_t size;
+    size_t used;
+    size_t peak;   // highest `used` since init
+} arena_t;
+
+void arena_init(arena_t *a, void *buf, size_t size);
+
+// size bytes aligned to ARENA_ALIGN, or NULL if the arena is full.
+void *arena_alloc(arena_t *a, size_t size);
+
+// As arena_alloc(), zero-filled.
+void *arena_calloc(arena_t *a, size_t size);
+
+void arena_reset(arena_t *a);
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef BOOT_PROFILE_H
+#define BOOT_PROFILE_H
+
+#include <stdint.h>
+
+// Milestones of a boot, stamped once each with esp_timer time (from CPU
+// start; the second-stage bootloader is not included).
+typedef enum {
+    BOOT_STAGE_NVS,
+    BOOT_STAGE_LITTLEFS,
+    BOOT_STAGE_SETTINGS,
+    BOOT_STAGE_LED_PANEL,
+    BOOT_STAGE_FONT,
+    BOOT_STAGE_DISPLAY,         // first text on the panel
+    BOOT_STAGE_WIFI_INIT,       // netif + WiFi driver initialized
+    BOOT_STAGE_NETWORK,         // STA connected (or AP up) and web server started
+    BOOT_STAGE_FIRST_HEADLINE,  // first feed item scrolled
+    BOOT_STAGE_COUNT
+} boot_stage_t;
+
+// Record the stage's time and log it. Later marks of the same stage are ignored.
+void boot_profile_mark(boot_stage_t stage);
+
+// Milliseconds since boot at which the stage was reached, or -1 if it hasn't been.
+int32_t boot_profile_get_ms(boot_stage_t stage);
+
+const char *boot_profile_stage_name(boot_stage_t stage);
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef DEFERRED_LOG_H
+#define DEFERRED_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "esp_log.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Deferred logging for hot paths. DLOGx() records the format pointer, up to
+// four int-sized arguments and an optional short string into a lock-free
+// ring and returns; a low-priority task formats and writes the line to the
+// console later, so a slow UART never stalls the caller. When the ring is
+// full the oldest entries are overwritten and counted as dropped.
+//
+// Formats must be string literals (only the pointer is stored). The _STR
+// variants copy str (truncated to DEFERRED_LOG_STR_LEN) and pass it as the
+// first conversion, so the format starts with %s.
+
+#define DEFERRED_LOG_RING_SIZE 64   // power of two
+#define DEFERRED_LOG_STR_LEN   48
+#define DEFERRED_LOG_MAX_TAGS  12   // tags with their own runtime level
+
+void deferred_log_write(esp_log_level_t level, const char *tag, const char *fmt,
+                        const char *str, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3);
+
+// Picks the first four variadic arguments, padding with zeros.
+#define DLOG_ARGS_(dummy, a0, a1, a2, a3, ...) \
+    (uint32_t)(a0), (uint32_t)(a1), (uint32_t)(a2), (uint32_t)(a3)
+#define DLOG_(level, tag, fmt, str, ...) \
+    deferred_log_write(level, tag, fmt, str, DLOG_ARGS_(0, ##__VA_ARGS__, 0, 0, 0, 0))
+
+#define DLOGE(tag, fmt, ...) DLOG_(ESP_LOG_ERROR, tag, fmt, NULL, ##__VA_ARGS__)
+#define DLOGW(tag, fmt, ...) DLOG_(ESP_LOG_WARN,  tag, fmt, NULL, ##__VA_ARGS__)
+#define DLOGI(tag, fmt, ...) DLOG_(ESP_LOG_INFO,  tag, fmt, NULL, ##__VA_ARGS__)
+#define DLOGD(tag, fmt, ...) DLOG_(ESP_LOG_DEBUG, tag, fmt, NULL, ##__VA_ARGS__)
+
+#define DLOGW_STR(tag, fmt, str, ...) DLOG_(ESP_LOG_WARN,  tag, fmt, str, ##__VA_ARGS__)
+#define DLOGI_STR(tag, fmt, str, ...) DLOG_(ESP_LOG_INFO,  tag, fmt, str, ##__VA_ARGS__)
+#define DLOGD_STR(tag, fmt, str, ...) DLOG_(ESP_LOG_DEBUG, tag, fmt, str, ##__VA_ARGS__)
+
+// Start the writer task. Entries recorded earlier are kept and written
+// once it runs.
+esp_err_t deferred_log_init(void);
+
+// Runtime level for tag ("*" sets the default for all other tags). Applies
+// to deferred entries and, through esp_log_level_set(), to ESP_LOGx too.
+esp_err_t deferred_log_set_level(const char *tag, esp_log_level_t level);
+
+// "none", "error", "warn", "info", "debug" or "verbose".
+bool deferred_log_parse_level(const char *name, esp_log_level_t *out);
+
+// Entries overwritten before the writer task got to them.
+uint32_t deferred_log_dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
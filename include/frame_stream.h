@@ -0,0 +1,45 @@
+#ifndef FRAME_STREAM_H
+#define FRAME_STREAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "esp_http_server.h"
+#include "led_panel.h"
+
+// Live preview of the panel over WebSocket. A low-priority task samples
+// the framebuffer after a refresh (led_panel_request_frame), encodes it and
+// pushes it to connected clients, so the render loop never waits on the
+// network.
+//
+// Binary messages:
+//   keyframe  0x01 cols rows  then cols*rows RGB triplets, column-major
+//   delta     0x02 shift count  then count * (col, rows RGB triplets)
+// A delta means: scroll the previous frame left by shift columns (blank
+// columns enter on the right), then overwrite the listed columns.
+#define FRAME_STREAM_MAX_CLIENTS 2
+#define FRAME_STREAM_DEFAULT_FPS 10
+#define FRAME_STREAM_MAX_FPS     20
+#define FRAME_STREAM_MAX_SHIFT   32    // largest scroll step searched for
+
+#define FRAME_STREAM_KEYFRAME 0x01
+#define FRAME_STREAM_DELTA    0x02
+
+// Largest encoded message (a keyframe at full width).
+#define FRAME_STREAM_MAX_MSG (3 + PANEL_MAX_COLS * PANEL_ROWS * 3)
+
+// Start streaming frames to a WebSocket client at fps (clamped to
+// 1..FRAME_STREAM_MAX_FPS). The first message is a keyframe. Returns
+// ESP_ERR_NO_MEM when all client slots are taken.
+esp_err_t frame_stream_add_client(httpd_handle_t server, int fd, int fps);
+
+// Forget all clients, e.g. when the web server stops.
+void frame_stream_remove_all(void);
+
+// Encode cur against prev into out (FRAME_STREAM_MAX_MSG bytes). prev may
+// be NULL to force a keyframe. Returns the message length, or 0 when the
+// frames are identical.
+size_t frame_stream_encode(const led_panel_frame_t *prev, const led_panel_frame_t *cur,
+                           uint8_t *out);
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef JSON_STREAM_H
+#define JSON_STREAM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Streaming JSON tokenizer with a fixed-size state block. Input may arrive in
+// arbitrary chunks; each token is reported to a callback with its path, e.g.
+// "events[].status.type.detail" (object members joined by '.', array elements
+// as "[]"). Strings longer than JSON_STREAM_MAX_VALUE are truncated; keys
+// longer than JSON_STREAM_MAX_KEY appear in the path as "~" and never match.
+
+#define JSON_STREAM_MAX_DEPTH 12
+#define JSON_STREAM_MAX_PATH  96
+#define JSON_STREAM_MAX_KEY   32
+#define JSON_STREAM_MAX_VALUE 256
+
+typedef enum {
+    JSON_STREAM_OBJECT_START,
+    JSON_STREAM_OBJECT_END,
+    JSON_STREAM_ARRAY_START,
+    JSON_STREAM_ARRAY_END,
+    JSON_STREAM_STRING,
+    JSON_STREAM_NUMBER,
+    JSON_STREAM_TRUE,
+    JSON_STREAM_FALSE,
+    JSON_STREAM_NULL,
+} json_stream_event_t;
+
+typedef enum {
+    JSON_STREAM_OK,       // more input expected, or document complete
+    JSON_STREAM_STOPPED,  // callback asked to stop
+    JSON_STREAM_ERROR,    // malformed input or nesting deeper than JSON_STREAM_MAX_DEPTH
+} json_stream_status_t;
+
+// value is NUL-terminated (decoded string or literal text; empty for containers).
+// Return false to stop parsing.
+typedef bool (*json_stream_cb_t)(void *ctx, json_stream_event_t event,
+                                 const char *path, const char *value, int value_len);
+
+typedef struct {
+    json_stream_cb_t cb;
+    void *ctx;
+    json_stream_status_t status;
+    uint8_t state;
+    uint8_t depth;
+    bool done;
+    bool in_key;
+    uint8_t unicode_digits;
+    uint16_t unicode_value;
+    char container[JSON_STREAM_MAX_DEPTH];
+    int16_t index[JSON_STREAM_MAX_DEPTH];
+    uint8_t path_len[JSON_STREAM_MAX_DEPTH + 1];
+    char path[JSON_STREAM_MAX_PATH + 1];
+    char key[JSON_STREAM_MAX_KEY + 1];
+    int key_len;
+    char value[JSON_STREAM_MAX_VALUE + 1];
+    int value_len;
+} json_stream_t;
+
+void json_stream_init(json_stream_t *js, json_stream_cb_t cb, void *ctx);
+
+// Feed the next chunk of input.
+json_stream_status_t json_stream_feed(json_stream_t *js, const char *data, size_t len);
+
+// Signal end of input. Returns JSON_STREAM_ERROR if the document is incomplete.
+json_stream_status_t json_stream_finish(json_stream_t *js);
+
+// Index of the current element in the innermost enclosing array, or -1.
+int json_stream_array_index(const json_stream_t *js);
+
+#endif
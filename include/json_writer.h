@@ -0,0 +1,56 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Streaming JSON emitter. Output accumulates in a caller-supplied buffer
+// and is handed to a flush callback whenever it fills, so documents of any
+// size are written without heap allocation. Commas are inserted
+// automatically; nesting is tracked up to JSON_WRITER_MAX_DEPTH.
+
+#define JSON_WRITER_MAX_DEPTH 8
+
+// Write len bytes of output. Return false to fail the writer; later calls
+// become no-ops and json_writer_finish() returns false.
+typedef bool (*json_writer_flush_cb_t)(void *ctx, const char *data, size_t len);
+
+typedef struct {
+    char *buf;
+    size_t size;
+    size_t len;
+    json_writer_flush_cb_t flush;
+    void *ctx;
+    bool failed;
+    bool after_key;
+    uint8_t depth;
+    bool has_value[JSON_WRITER_MAX_DEPTH];  // open container already has a value
+} json_writer_t;
+
+void json_writer_init(json_writer_t *w, char *buf, size_t size,
+                      json_writer_flush_cb_t flush, void *ctx);
+
+void json_writer_object_start(json_writer_t *w);
+void json_writer_object_end(json_writer_t *w);
+void json_writer_array_start(json_writer_t *w);
+void json_writer_array_end(json_writer_t *w);
+
+// Member name; the next value call supplies its value.
+void json_writer_key(json_writer_t *w, const char *key);
+
+void json_writer_string(json_writer_t *w, const char *value);
+void json_writer_int(json_writer_t *w, int64_t value);
+void json_writer_bool(json_writer_t *w, bool value);
+void json_writer_null(json_writer_t *w);
+
+// key + value shorthands for object members.
+void json_writer_kv_string(json_writer_t *w, const char *key, const char *value);
+void json_writer_kv_int(json_writer_t *w, const char *key, int64_t value);
+void json_writer_kv_bool(json_writer_t *w, const char *key, bool value);
+
+// Flush what is buffered. Returns false if any write failed or the
+// containers were not balanced.
+bool json_writer_finish(json_writer_t *w);
+
+#endif
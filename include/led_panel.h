@@ -2,6 +2,9 @@
 #define LED_PANEL_H
 
 #include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "esp_err.h"
 
 #ifdef __cplusplus
@@ -22,6 +25,27 @@ typedef struct {
     uint8_t b;
 } pixel_rgb_t;
 
+// Output timing, to catch glitches and stalls. A refresh is slow when
+// FastLED.show() overruns the wire time of the active LEDs by more than
+// LED_PANEL_SLOW_REFRESH_US (the RMT buffer was refilled late); a stall is a
+// gap between refreshes longer than LED_PANEL_STALL_MS.
+#define LED_PANEL_SLOW_REFRESH_US 1000
+#define LED_PANEL_STALL_MS        100
+
+typedef struct {
+    uint32_t refresh_count;
+    uint32_t slow_refreshes;
+    uint32_t max_refresh_us;
+    uint32_t stalls;
+    uint32_t max_gap_ms;
+} led_panel_stats_t;
+
+// Copy of a refreshed frame, for the web preview.
+typedef struct {
+    uint8_t cols;
+    pixel_rgb_t px[PANEL_ROWS][PANEL_MAX_COLS];
+} led_panel_frame_t;
+
 esp_err_t led_panel_init(void);
 void led_panel_clear(void);
 void led_panel_set_pixel(int row, int col, uint8_t r, uint8_t g, uint8_t b);
@@ -30,6 +54,16 @@ esp_err_t led_panel_refresh(void);
 void led_panel_set_brightness(uint8_t brightness);
 void led_panel_set_cols(uint8_t cols);
 uint8_t led_panel_get_cols(void);
+void led_panel_get_stats(led_panel_stats_t *out);
+
+// Ask the next led_panel_refresh() to copy its frame into dst and then
+// notify task (xTaskNotifyGive). The render path only pays a memcpy; a
+// newer request replaces one not yet served.
+void led_panel_request_frame(led_panel_frame_t *dst, TaskHandle_t task);
+
+// Withdraw a request not yet served. Returns false if a refresh has already
+// taken it: the copy is then in progress and its notification will follow.
+bool led_panel_cancel_frame_request(void);
 
 #ifdef __cplusplus
 }
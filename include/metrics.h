@@ -0,0 +1,51 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "settings.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Numeric telemetry for GET /metrics (Prometheus text exposition format).
+// Recording is a few relaxed 32-bit atomic adds, so it is safe from the
+// display loop and the network tasks without locks. Each histogram has a
+// single writer (the task named below), which owns its sub-millisecond
+// sum remainder.
+
+typedef enum {
+    METRIC_NVS_WRITE_BYTES,       // settings blob, fast-connect AP
+    METRIC_LITTLEFS_WRITE_BYTES,  // feed cache files
+    METRIC_RSS_CACHE_HITS,        // item picks and availability checks served from cache
+    METRIC_RSS_CACHE_MISSES,
+    METRIC_COUNTER_COUNT
+} metrics_counter_t;
+
+void metrics_add(metrics_counter_t counter, uint32_t n);
+
+// Interval between LED refreshes (display task).
+void metrics_observe_frame_interval_us(uint32_t us);
+
+// One feed fetch from url (feed refresh task). Series follow the URL, and
+// are labelled with whichever source has that URL when rendered.
+void metrics_observe_fetch(const char *url, uint32_t duration_us, uint32_t bytes, bool ok);
+
+// One radio_on() association attempt (whichever task turned the radio on).
+void metrics_observe_wifi_reconnect(uint32_t duration_us, bool connected);
+
+// Write len bytes of output; return false to stop rendering.
+typedef bool (*metrics_flush_cb_t)(void *ctx, const char *data, size_t len);
+
+// Render all metrics through buf (flushed whenever it fills). Source
+// labels come from s. Returns false if a flush failed.
+bool metrics_render(const app_settings_t *s, char *buf, size_t size,
+                    metrics_flush_cb_t flush, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef REALTIME_INGEST_H
+#define REALTIME_INGEST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+#include "led_panel.h"
+
+// Realtime frames from a PC over UDP, in DDP (Distributed Display
+// Protocol) packets. While packets keep arriving the display loop shows
+// these frames instead of the scroller; REALTIME_INGEST_TIMEOUT_MS after
+// the last one it falls back to normal scrolling.
+//
+// Pixel data is 8-bit RGB, addressed by byte offset in column-major order:
+// pixel (row, col) starts at (col * PANEL_ROWS + row) * 3, so a whole frame
+// and a single 24-byte column strip use the same layout. A packet with the
+// PUSH flag completes a frame.
+#define REALTIME_INGEST_PORT        4048
+#define REALTIME_INGEST_TIMEOUT_MS  2000
+#define REALTIME_INGEST_FRAME_BYTES (PANEL_MAX_COLS * PANEL_ROWS * 3)
+
+// DDP header (10 bytes, 14 with a timecode).
+#define DDP_HEADER_LEN     10
+#define DDP_TIMECODE_LEN   4
+#define DDP_FLAG_VER_MASK  0xC0
+#define DDP_FLAG_VER1      0x40
+#define DDP_FLAG_TIMECODE  0x10
+#define DDP_FLAG_STORAGE   0x08
+#define DDP_FLAG_REPLY     0x04
+#define DDP_FLAG_QUERY     0x02
+#define DDP_FLAG_PUSH      0x01
+#define DDP_SEQ_MASK       0x0F   // 1..15, 0 = not used
+#define DDP_ID_DISPLAY     1
+
+typedef struct {
+    uint32_t packets;
+    uint32_t frames;           // frames handed to the display loop
+    uint32_t frames_torn;      // dropped: a packet of the frame was lost
+    uint32_t frames_skipped;   // replaced by a newer frame before display
+    uint32_t packets_late;     // out-of-order or duplicate sequence number
+    uint32_t packets_invalid;
+} realtime_ingest_stats_t;
+
+// Open the UDP listener. Safe to call again while running.
+esp_err_t realtime_ingest_start(void);
+
+// Close the listener; the display falls back to scrolling.
+void realtime_ingest_stop(void);
+
+// True while realtime packets have arrived within the timeout.
+bool realtime_ingest_active(void);
+
+// Wait up to wait ticks for a frame newer than the last one taken. On
+// success *rgb points at REALTIME_INGEST_FRAME_BYTES of pixel data, valid
+// until the next call. Frames that arrive faster than they are taken are
+// skipped (latest wins).
+bool realtime_ingest_wait_frame(const uint8_t **rgb, TickType_t wait);
+
+void realtime_ingest_get_stats(realtime_ingest_stats_t *out);
+
+#endif
@@ -2,10 +2,19 @@
 #define RSS_CACHE_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include "esp_err.h"
 #include "rss_fetcher.h"
 
-#define RSS_CACHE_ITEM_FLAG_LIVE 0x01
+// Cached items share the fetcher's flag bits.
+#define RSS_CACHE_ITEM_FLAG_LIVE RSS_ITEM_FLAG_LIVE
+
+typedef struct {
+    uint32_t item_count;
+    uint32_t updated_epoch;
+    uint32_t content_hash;  // changes whenever any cached item does
+    uint16_t live_count;
+} rss_cache_source_info_t;
 
 esp_err_t rss_cache_init(void);
 
@@ -15,6 +24,9 @@ esp_err_t rss_cache_store_from_fetcher(const char *source_url, const char *sourc
 // Check whether cached data exists for this URL and has at least one item.
 bool rss_cache_has_items_for_url(const char *source_url);
 
+// Read the cache header for this URL. Returns ESP_ERR_NOT_FOUND when nothing is cached.
+esp_err_t rss_cache_get_source_info(const char *source_url, rss_cache_source_info_t *out_info);
+
 // Pick one random item across all provided source URLs (weighted by item count)
 // without repeats until all cached items have been shown once.
 esp_err_t rss_cache_pick_random_item(const char *const *source_urls,
@@ -1,23 +1,54 @@
 #ifndef RSS_FETCHER_H
 #define RSS_FETCHER_H
 
+#include <stdint.h>
 #include "esp_err.h"
 
 #define RSS_MAX_ITEMS    30
 #define RSS_TITLE_LEN    200
 #define RSS_DESC_LEN     200
 
+// Item flags. Scroller-feed sources classify items server-side and set
+// RSS_ITEM_FLAG_CLASSIFIED; RSS items leave flags at 0 for the cache to infer.
+#define RSS_ITEM_FLAG_LIVE       0x01
+#define RSS_ITEM_FLAG_FINAL      0x02
+#define RSS_ITEM_FLAG_CLASSIFIED 0x80
+
 typedef struct {
     char title[RSS_TITLE_LEN + 1];
     char description[RSS_DESC_LEN + 1];
+    uint8_t flags;
+    uint32_t hash;  // FNV-1a of title, 0x1F, description
 } rss_item_t;
 
-// Fetch and parse an RSS feed. Call with WiFi connected.
+#define RSS_FETCH_DEFAULT_TIMEOUT_MS 10000
+
+typedef struct {
+    // JSON sources: field paths such as "events[].name". The part up to the
+    // last "[]" selects the item array; both paths must share it. Leave NULL
+    // for RSS/scroller-feed sources.
+    const char *json_title_path;
+    const char *json_desc_path;
+    // Socket timeout per network operation; 0 uses RSS_FETCH_DEFAULT_TIMEOUT_MS.
+    uint32_t timeout_ms;
+    // Absolute esp_timer_get_time() deadline for the whole fetch; 0 for none.
+    // Reading stops with ESP_ERR_TIMEOUT once it passes.
+    int64_t deadline_us;
+} rss_fetch_options_t;
+
+// Fetch and parse a feed (RSS XML, or the binary scroller-feed format when the
+// server honours the Accept header). Call with WiFi connected.
 esp_err_t rss_fetch(const char *url);
 
+// Same as rss_fetch(), with per-source options (may be NULL).
+esp_err_t rss_fetch_ex(const char *url, const rss_fetch_options_t *options);
+
 // Number of items parsed from last successful fetch (0 if none)
 int rss_get_count(void);
 
+// Response bytes read by the last fetch, whether or not it succeeded.
+int rss_get_last_fetch_bytes(void);
+
 // Get parsed item by index. Returns NULL if out of range.
 const rss_item_t *rss_get_item(int index);
 
@@ -0,0 +1,70 @@
+#ifndef RSS_SCHEDULER_H
+#define RSS_SCHEDULER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+#include "settings.h"
+#include "rss_cache.h"
+
+// Per-source refresh deadlines. Each enabled source keeps its own interval,
+// which shrinks while the source has live items or its content keeps
+// changing, and grows while it stays the same.
+#define RSS_SCHED_LIVE_INTERVAL_MS    (2 * 60 * 1000)
+#define RSS_SCHED_MIN_INTERVAL_MS     (5 * 60 * 1000)
+#define RSS_SCHED_DEFAULT_INTERVAL_MS (15 * 60 * 1000)
+#define RSS_SCHED_MAX_INTERVAL_MS     (60 * 60 * 1000)
+#define RSS_SCHED_RETRY_MS            (60 * 1000)
+
+// Failing sources back off exponentially from RSS_SCHED_RETRY_MS, with
+// +/-25% jitter, so a dead host costs nothing until its next attempt.
+#define RSS_SCHED_BACKOFF_MAX_MS      (30 * 60 * 1000)
+
+// Sources due within this window are fetched early so they share one radio-on window.
+#define RSS_SCHED_BATCH_SLACK_MS      (90 * 1000)
+
+typedef struct {
+    char name[SETTINGS_MAX_RSS_NAME_LEN + 1];
+    uint32_t interval_ms;          // current refresh interval while healthy
+    uint32_t next_attempt_ms;      // time until the source is eligible (0 = due)
+    uint16_t consecutive_failures;
+    esp_err_t last_error;          // ESP_OK until a fetch fails
+    bool fetched;                  // at least one successful fetch since boot
+    bool live;
+} rss_source_health_t;
+
+esp_err_t rss_scheduler_init(void);
+
+// Match the scheduler's table to the enabled sources in settings. Sources
+// that stay enabled keep their state; new ones are due immediately.
+void rss_scheduler_sync(const app_settings_t *s, TickType_t now);
+
+// Fill order[] with the indices (into s->rss_sources) of the due sources, in
+// the order a refresh window should fetch them: sources with live items
+// first, then healthy before failing, then the most overdue. Returns the count.
+int rss_scheduler_plan(const app_settings_t *s, TickType_t now, int *order, int max);
+
+// Record a fetch that reached the cache; info is the freshly written header.
+void rss_scheduler_record_success(const char *url, const rss_cache_source_info_t *info,
+                                  TickType_t now);
+
+// Record a failed fetch (HTTP/parse error or nothing cached). The source is
+// skipped until its backoff expires.
+void rss_scheduler_record_failure(const char *url, esp_err_t err, TickType_t now);
+
+// Push one source back by delay_ms without counting a failure, e.g. when
+// the refresh window ran out of budget before reaching it.
+void rss_scheduler_defer(const char *url, TickType_t now, uint32_t delay_ms);
+
+// Push every currently due source back by delay_ms without touching its
+// interval, e.g. when WiFi could not be brought up for the window.
+void rss_scheduler_defer_due(TickType_t now, uint32_t delay_ms);
+
+// Copy the health state for one source. Returns false if the URL is not scheduled.
+bool rss_scheduler_get_health(const char *url, TickType_t now, rss_source_health_t *out);
+
+// Earliest deadline among the synced sources (now + default interval if none).
+TickType_t rss_scheduler_next_due(TickType_t now);
+
+#endif
@@ -8,10 +8,19 @@
 #define SETTINGS_MAX_TEXT_LEN     200
 #define SETTINGS_MAX_SSID_LEN    32
 #define SETTINGS_MAX_PASS_LEN    64
+#define SETTINGS_MAX_IP_LEN      15
 #define MAX_MESSAGES              5
 #define SETTINGS_MAX_URL_LEN     256
 #define MAX_RSS_SOURCES           8
 #define SETTINGS_MAX_RSS_NAME_LEN 24
+#define SETTINGS_MAX_JSON_PATH_LEN 64
+#define SETTINGS_MIN_REFRESH_BUDGET_S 10
+#define SETTINGS_MAX_REFRESH_BUDGET_S 120
+
+typedef enum {
+    RSS_SOURCE_TYPE_RSS = 0,   // RSS XML (or scroller feed, negotiated per request)
+    RSS_SOURCE_TYPE_JSON,      // JSON document mapped via the source's json_*_path
+} rss_source_type_t;
 
 typedef struct {
     char text[SETTINGS_MAX_TEXT_LEN + 1];
@@ -25,6 +34,9 @@ typedef struct {
     bool enabled;
     char name[SETTINGS_MAX_RSS_NAME_LEN + 1];
     char url[SETTINGS_MAX_URL_LEN + 1];
+    uint8_t type;        // rss_source_type_t
+    char json_title_path[SETTINGS_MAX_JSON_PATH_LEN + 1];  // JSON sources only
+    char json_desc_path[SETTINGS_MAX_JSON_PATH_LEN + 1];
 } rss_source_t;
 
 typedef struct {
@@ -34,6 +46,11 @@ typedef struct {
     uint8_t panel_cols;  // 32, 64, 96, or 128
     char wifi_ssid[SETTINGS_MAX_SSID_LEN + 1];
     char wifi_password[SETTINGS_MAX_PASS_LEN + 1];
+    bool wifi_static_enabled;  // use the fixed address below instead of DHCP
+    char wifi_static_ip[SETTINGS_MAX_IP_LEN + 1];
+    char wifi_static_gateway[SETTINGS_MAX_IP_LEN + 1];
+    char wifi_static_netmask[SETTINGS_MAX_IP_LEN + 1];
+    char wifi_static_dns[SETTINGS_MAX_IP_LEN + 1];  // empty = gateway
     bool rss_enabled;
     char rss_url[SETTINGS_MAX_URL_LEN + 1];
     bool rss_npr_enabled;
@@ -45,12 +62,68 @@ typedef struct {
     bool rss_sport_nfl_enabled;
     bool rss_sport_nba_enabled;
     bool rss_sport_big10_enabled;
+    bool rss_json_enabled;
+    char rss_json_name[SETTINGS_MAX_RSS_NAME_LEN + 1];
+    char rss_json_url[SETTINGS_MAX_URL_LEN + 1];
+    char rss_json_title_path[SETTINGS_MAX_JSON_PATH_LEN + 1];  // e.g. "events[].name"; copied
+    char rss_json_desc_path[SETTINGS_MAX_JSON_PATH_LEN + 1];   // into its rss_sources entry
+    uint8_t rss_refresh_budget_s;  // max radio-on seconds per feed refresh window
+    bool rss_background_refresh;   // fetch on core 0 while the display keeps scrolling
+    // Everything above is persisted as the settings blob (see settings.c);
+    // add new persisted fields directly above this line.
     uint8_t rss_source_count;
     rss_source_t rss_sources[MAX_RSS_SOURCES];
 } app_settings_t;
 
+// Field groups for dirty tracking.
+typedef enum {
+    SETTINGS_FIELD_MESSAGES   = 1 << 0,
+    SETTINGS_FIELD_SPEED      = 1 << 1,
+    SETTINGS_FIELD_BRIGHTNESS = 1 << 2,
+    SETTINGS_FIELD_PANEL      = 1 << 3,
+    SETTINGS_FIELD_WIFI       = 1 << 4,
+    SETTINGS_FIELD_RSS        = 1 << 5,
+    SETTINGS_FIELD_REFRESH    = 1 << 6,
+} settings_field_t;
+
+// Changes are written once no further change has arrived for this long.
+#define SETTINGS_FLUSH_DELAY_MS 2000
+
+// Called after a new snapshot is published, outside any settings lock.
+// fields is the settings_field_t mask the edit changed. The snapshot stays
+// valid for the duration of the call; acquire it to keep it longer.
+typedef void (*settings_change_cb_t)(const app_settings_t *snapshot, uint32_t fields, void *ctx);
+
 esp_err_t settings_init(void);
-esp_err_t settings_save(const app_settings_t *settings);
-app_settings_t *settings_get(void);
+
+// Current settings as an immutable snapshot. Never blocks. Every acquire
+// must be paired with settings_release(); hold snapshots briefly, since an
+// edit waits for a free slot while readers pin all the old ones.
+const app_settings_t *settings_acquire(void);
+void settings_release(const app_settings_t *s);
+
+// Bumped each time a snapshot is published. Compare against a saved value
+// to see whether anything changed without acquiring a snapshot.
+uint32_t settings_get_generation(void);
+
+// Start an edit: returns a private copy of the current settings, or NULL if
+// no snapshot slot frees up. Edits are serialized; finish every non-NULL
+// draft with exactly one commit or abort, and don't start another edit
+// from the same task before that.
+app_settings_t *settings_edit_begin(void);
+
+// Publish the draft, mark fields (a settings_field_t mask) dirty for the
+// debounced NVS flush and notify subscribers.
+void settings_edit_commit(app_settings_t *draft, uint32_t fields);
+void settings_edit_abort(app_settings_t *draft);
+
+// Register cb for every committed edit. Up to 4 subscribers.
+esp_err_t settings_subscribe(settings_change_cb_t cb, void *ctx);
+
+// Write pending changes now. No-op when nothing is dirty.
+esp_err_t settings_flush(void);
+
+// Mask of settings_field_t changed since the last flush.
+uint32_t settings_get_dirty(void);
 
 #endif
@@ -0,0 +1,43 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Fixed-size, lock-free trace rings for the refresh and render pipelines,
+// exported from /api/trace as Chrome trace JSON (open in Perfetto or
+// chrome://tracing). Recording claims a slot with one atomic add and never
+// blocks; the oldest events are overwritten. Events are tracked per CPU
+// core, so begin/end pairs must come from tasks pinned to one core.
+//
+// Names must be string literals (only the pointer is stored).
+
+typedef enum {
+    TRACE_CAT_REFRESH,  // feed refresh, fetch, cache, WiFi transitions
+    TRACE_CAT_RENDER,   // LED refreshes; high rate, so kept apart
+    TRACE_CAT_COUNT
+} trace_cat_t;
+
+#define TRACE_REFRESH_EVENTS 256   // powers of two
+#define TRACE_RENDER_EVENTS  128
+
+void trace_begin(trace_cat_t cat, const char *name, int32_t arg);
+void trace_end(trace_cat_t cat, const char *name, int32_t arg);
+void trace_instant(trace_cat_t cat, const char *name, int32_t arg);
+
+// Write len bytes of output; return false to stop.
+typedef bool (*trace_flush_cb_t)(void *ctx, const char *data, size_t len);
+
+// Write both rings as one Chrome trace JSON document through buf.
+bool trace_export(char *buf, size_t size, trace_flush_cb_t flush, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef WEB_WORKER_H
+#define WEB_WORKER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "settings.h"
+
+// Slow web operations run on a worker task so the httpd task only
+// validates, queues and answers 202 with an operation ID.
+#define WEB_WORKER_QUEUE_LEN 4
+#define WEB_WORKER_OP_SLOTS  8    // recent operations kept for polling
+
+// How long a WiFi connect operation waits for the association result.
+#define WEB_WORKER_WIFI_TIMEOUT_MS 20000
+
+typedef enum {
+    WEB_OP_WIFI_CONNECT,
+    WEB_OP_FACTORY_RESET,
+} web_op_type_t;
+
+typedef enum {
+    WEB_OP_PENDING,
+    WEB_OP_RUNNING,
+    WEB_OP_DONE,
+    WEB_OP_FAILED,
+} web_op_state_t;
+
+// Static address fields a WiFi connect saves before connecting.
+#define WEB_OP_STATIC_ENABLED (1u << 0)
+#define WEB_OP_STATIC_IP      (1u << 1)
+#define WEB_OP_STATIC_GATEWAY (1u << 2)
+#define WEB_OP_STATIC_NETMASK (1u << 3)
+#define WEB_OP_STATIC_DNS     (1u << 4)
+
+typedef struct {
+    web_op_type_t type;
+    union {
+        struct {
+            char ssid[SETTINGS_MAX_SSID_LEN + 1];
+            char password[SETTINGS_MAX_PASS_LEN + 1];
+            uint8_t static_fields;  // WEB_OP_STATIC_* sent with the request
+            bool static_enabled;
+            char static_ip[SETTINGS_MAX_IP_LEN + 1];
+            char static_gateway[SETTINGS_MAX_IP_LEN + 1];
+            char static_netmask[SETTINGS_MAX_IP_LEN + 1];
+            char static_dns[SETTINGS_MAX_IP_LEN + 1];
+        } wifi;
+    };
+} web_op_t;
+
+typedef struct {
+    uint32_t id;
+    web_op_type_t type;
+    web_op_state_t state;
+    char message[64];
+} web_op_status_t;
+
+// Create the queue and worker task. Safe to call again once running.
+esp_err_t web_worker_init(void);
+
+// Queue op and return its ID (never 0), or 0 if the queue is full.
+uint32_t web_worker_submit(const web_op_t *op);
+
+// Copy the status of a recent operation. Returns false if id is unknown
+// or has been overwritten by newer operations.
+bool web_worker_get_status(uint32_t id, web_op_status_t *out);
+
+const char *web_worker_state_name(web_op_state_t state);
+
+#endif
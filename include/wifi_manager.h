@@ -11,6 +11,17 @@ typedef enum {
     WIFI_MGR_MODE_STA_CONNECTING
 } wifi_mgr_mode_t;
 
+typedef struct {
+    uint32_t count;            // successful radio_on() reconnects
+    uint32_t fast_path_count;  // of which joined the cached BSSID/channel directly
+    uint32_t failures;
+    uint32_t last_ms;
+    uint32_t min_ms;
+    uint32_t max_ms;
+    uint64_t total_ms;
+    bool last_fast_path;
+} wifi_reconnect_stats_t;
+
 void wifi_manager_init(void);
 void wifi_manager_start(void);
 wifi_mgr_mode_t wifi_manager_get_mode(void);
@@ -19,5 +30,6 @@ const char *wifi_manager_get_ssid(void);
 void wifi_manager_set_sta_credentials(const char *ssid, const char *password);
 bool wifi_manager_radio_on(void);   // re-enable WiFi radio (STA mode only), returns true if connected
 void wifi_manager_radio_off(void);  // disable WiFi radio
+void wifi_manager_get_reconnect_stats(wifi_reconnect_stats_t *out);
 
 #endif
@@ -0,0 +1,176 @@
+"""Stand-in PC sender for the realtime DDP frame input (UDP 4048).
+
+    python scripts/ddp_send.py send 192.168.1.50 --pattern rainbow --fps 30
+    python scripts/ddp_send.py send 192.168.1.50 --pattern wipe --strips
+    python scripts/ddp_send.py listen --port 4048
+
+`send` streams a test pattern as DDP packets: whole frames split into
+packets of at most --max-data bytes with PUSH on the last one, or with
+--strips one 24-byte packet per changed column. --drop discards a fraction
+of packets to exercise the device's torn-frame handling. `listen` is a
+local receiver that applies the same sequence and push rules as
+realtime_ingest.c and prints what it would show.
+
+Pixel layout matches the device: 8-bit RGB, column-major, so pixel
+(row, col) is at byte (col * ROWS + row) * 3.
+"""
+
+import argparse
+import colorsys
+import random
+import socket
+import struct
+import sys
+import time
+
+PORT = 4048
+ROWS = 8
+FLAG_VER1 = 0x40
+FLAG_PUSH = 0x01
+FLAG_TIMECODE = 0x10
+ID_DISPLAY = 1
+HEADER = struct.Struct(">BBBBIH")
+
+
+def packet(seq, offset, data, push):
+    flags = FLAG_VER1 | (FLAG_PUSH if push else 0)
+    return HEADER.pack(flags, seq, 0x0B, ID_DISPLAY, offset, len(data)) + data
+
+
+def next_seq(seq):
+    return 1 if seq >= 15 else seq + 1
+
+
+def pattern_frame(name, cols, t):
+    frame = bytearray(cols * ROWS * 3)
+    for col in range(cols):
+        for row in range(ROWS):
+            if name == "rainbow":
+                r, g, b = colorsys.hsv_to_rgb(((col + t * 20) % cols) / cols, 1, 1)
+            elif name == "wipe":
+                lit = col <= int(t * 16) % (cols + 1)
+                r, g, b = (0, 0.6, 1) if lit else (0, 0, 0)
+            else:  # bars
+                r, g, b = (1, 1, 1) if (row + col + int(t * 8)) % 8 < 2 else (0.1, 0, 0.2)
+            i = (col * ROWS + row) * 3
+            frame[i:i + 3] = bytes((int(r * 255), int(g * 255), int(b * 255)))
+    return frame
+
+
+def send(args):
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    dest = (args.host, args.port)
+    col_bytes = ROWS * 3
+    seq = 0
+    sent = 0
+    prev = None
+    start = time.monotonic()
+    frames = 0
+    try:
+        while args.frames == 0 or frames < args.frames:
+            t = time.monotonic() - start
+            frame = pattern_frame(args.pattern, args.cols, t)
+            chunks = []
+            if args.strips and prev is not None:
+                for col in range(args.cols):
+                    off = col * col_bytes
+                    if frame[off:off + col_bytes] != prev[off:off + col_bytes]:
+                        chunks.append((off, frame[off:off + col_bytes]))
+                if not chunks:
+                    chunks.append((0, frame[0:col_bytes]))
+            else:
+                for off in range(0, len(frame), args.max_data):
+                    chunks.append((off, frame[off:off + args.max_data]))
+
+            for i, (off, data) in enumerate(chunks):
+                seq = next_seq(seq)
+                if random.random() < args.drop:
+                    continue
+                sock.sendto(packet(seq, off, bytes(data), i == len(chunks) - 1), dest)
+                sent += 1
+
+            prev = frame
+            frames += 1
+            if frames % max(1, args.fps) == 0:
+                print("%d frames, %d packets" % (frames, sent))
+            time.sleep(max(0.0, start + frames / args.fps - time.monotonic()))
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+
+def listen(args):
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind(("", args.port))
+    sock.settimeout(2.0)
+    last_seq = 0
+    torn = False
+    stats = {"packets": 0, "frames": 0, "torn": 0, "late": 0, "invalid": 0}
+    window = time.monotonic()
+    print("listening on UDP %d" % args.port)
+    try:
+        while True:
+            try:
+                data = sock.recv(2048)
+            except socket.timeout:
+                if last_seq:
+                    print("timeout: device would resume scrolling")
+                last_seq, torn = 0, False
+                continue
+            if len(data) < HEADER.size or data[0] & 0xC0 != FLAG_VER1 or data[3] != ID_DISPLAY:
+                stats["invalid"] += 1
+                continue
+            flags, seq, _, _, offset, length = HEADER.unpack_from(data)
+            header = HEADER.size + (4 if flags & FLAG_TIMECODE else 0)
+            if header + length > len(data):
+                stats["invalid"] += 1
+                continue
+            seq &= 0x0F
+            if seq and last_seq:
+                step = (seq - last_seq + 15) % 15
+                if step == 0 or step >= 8:
+                    stats["late"] += 1
+                    continue
+                if step > 1:
+                    torn = True
+            if seq:
+                last_seq = seq
+            stats["packets"] += 1
+            if flags & FLAG_PUSH:
+                stats["torn" if torn else "frames"] += 1
+                torn = False
+            now = time.monotonic()
+            if now - window >= 1.0:
+                print(" ".join("%s=%d" % kv for kv in stats.items()))
+                window = now
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    sub = parser.add_subparsers(dest="cmd", required=True)
+
+    p_send = sub.add_parser("send", help="stream a test pattern to the device")
+    p_send.add_argument("host")
+    p_send.add_argument("--port", type=int, default=PORT)
+    p_send.add_argument("--cols", type=int, default=32)
+    p_send.add_argument("--fps", type=int, default=30)
+    p_send.add_argument("--frames", type=int, default=0, help="stop after N frames (0 = run until Ctrl-C)")
+    p_send.add_argument("--pattern", choices=("rainbow", "wipe", "bars"), default="rainbow")
+    p_send.add_argument("--strips", action="store_true", help="send only changed columns")
+    p_send.add_argument("--max-data", type=int, default=1440, help="pixel bytes per packet")
+    p_send.add_argument("--drop", type=float, default=0.0, help="fraction of packets to drop")
+
+    p_listen = sub.add_parser("listen", help="receive and check DDP packets locally")
+    p_listen.add_argument("--port", type=int, default=PORT)
+
+    args = parser.parse_args()
+    if args.cmd == "send":
+        return send(args)
+    return listen(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
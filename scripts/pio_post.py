@@ -1,5 +1,8 @@
 import csv
+import gzip
+import hashlib
 import os
+import shutil
 import subprocess
 import sys
 
@@ -47,6 +50,33 @@ def parse_partitions(csv_path):
     return partitions
 
 
+# Web assets get a gzip copy (<file>.gz) and a content hash (<file>.etag)
+# that send_file_response() serves as the ETag.
+COMPRESSIBLE_EXTENSIONS = (".html", ".js", ".css", ".json", ".svg")
+
+
+def stage_littlefs(source_dir, staging_dir):
+    if os.path.isdir(staging_dir):
+        shutil.rmtree(staging_dir)
+    shutil.copytree(source_dir, staging_dir)
+
+    web_dir = os.path.join(staging_dir, "web")
+    for root, _dirs, files in os.walk(web_dir):
+        for name in files:
+            if not name.endswith(COMPRESSIBLE_EXTENSIONS):
+                continue
+            path = os.path.join(root, name)
+            with open(path, "rb") as fp:
+                data = fp.read()
+            # mtime=0 keeps the image byte-identical across rebuilds.
+            packed = gzip.compress(data, compresslevel=9, mtime=0)
+            with open(path + ".gz", "wb") as fp:
+                fp.write(packed)
+            with open(path + ".etag", "w", encoding="ascii") as fp:
+                fp.write(hashlib.sha256(data).hexdigest()[:16])
+            print("littlefs: %s %d -> %d bytes gzipped" % (os.path.relpath(path, staging_dir), len(data), len(packed)))
+
+
 def find_partition(partitions, name):
     for part in partitions:
         if part["name"] == name:
@@ -113,8 +143,9 @@ def generate_flash_artifacts(source, target, env):
     tool_dir = env.PioPlatform().get_package_dir("tool-mklittlefs")
     tool_name = "mklittlefs.exe" if sys.platform.startswith("win") else "mklittlefs"
     mklittlefs = os.path.join(tool_dir, tool_name)
-    littlefs_dir = os.path.join(project_dir, "littlefs")
+    littlefs_dir = os.path.join(build_dir, "littlefs_staged")
     littlefs_image = os.path.join(build_dir, "littlefs.bin")
+    stage_littlefs(os.path.join(project_dir, "littlefs"), littlefs_dir)
 
     subprocess.check_call(
         [
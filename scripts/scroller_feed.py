@@ -0,0 +1,208 @@
+"""Reference encoder and local stand-in server for the binary scroller feed.
+
+    python scripts/scroller_feed.py encode feed.xml feed.bin
+    python scripts/scroller_feed.py decode feed.bin
+    python scripts/scroller_feed.py serve --dir corpus --port 8080
+
+The stand-in server answers the same requests the device makes to the sports
+proxy (`espn_scores_rss.php?sport=mlb&format=rss`, or any `<name>.xml` path)
+from RSS files in --dir. It returns the scroller feed when the request carries
+`Accept: application/x-scroller-feed` or `fmt=scroller`, and RSS otherwise.
+Requests for `<name>.json` are served verbatim from --dir, for JSON sources.
+"""
+
+import argparse
+import html
+import os
+import re
+import struct
+import sys
+import xml.etree.ElementTree as ET
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import parse_qs, urlparse
+
+MAGIC = b"MCSF"
+VERSION = 1
+CONTENT_TYPE = "application/x-scroller-feed"
+
+MAX_ITEMS = 30
+MAX_TEXT_LEN = 200
+
+FLAG_LIVE = 0x01
+FLAG_FINAL = 0x02
+
+# Keep in sync with infer_item_flags() in src/rss_cache.c.
+FINISHED_MARKERS = (" final", "final ", "final/", "postponed", "cancelled", "canceled", "suspended")
+LIVE_MARKERS = (
+    "in progress", "halftime", "top ", "bottom ", "bot ", "end of ", "start of ",
+    "q1", "q2", "q3", "q4", "1st period", "2nd period", "3rd period", "overtime", " ot ",
+)
+
+# Same substitutions sanitize_to_ascii() in src/rss_fetcher.c applies.
+UNICODE_REPLACEMENTS = {
+    "–": "-", "—": "-", "‘": "'", "’": "'",
+    "“": '"', "”": '"', "•": "*", "…": "...",
+}
+
+
+def sanitize(text):
+    text = re.sub(r"<[^>]*>", "", text or "")
+    text = html.unescape(text)
+    out = []
+    for ch in text:
+        if ch in UNICODE_REPLACEMENTS:
+            out.append(UNICODE_REPLACEMENTS[ch])
+        elif ch in "\t\r\n":
+            out.append(" ")
+        elif 32 <= ord(ch) <= 126:
+            out.append(ch)
+    text = re.sub(r" {2,}", " ", "".join(out)).strip()
+    return text[:MAX_TEXT_LEN]
+
+
+def classify(title, description):
+    haystack = (title + "\n" + description).lower()
+    if any(m in haystack for m in FINISHED_MARKERS):
+        return FLAG_FINAL
+    if any(m in haystack for m in LIVE_MARKERS):
+        return FLAG_LIVE
+    return 0
+
+
+def item_hash(title, description):
+    h = 2166136261
+    for b in title.encode("ascii") + b"\x1f" + description.encode("ascii"):
+        h ^= b
+        h = (h * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def parse_rss(xml_bytes):
+    root = ET.fromstring(xml_bytes)
+    items = []
+    for node in root.iter("item"):
+        title = sanitize(node.findtext("title"))
+        if not title:
+            continue
+        items.append((title, sanitize(node.findtext("description"))))
+        if len(items) >= MAX_ITEMS:
+            break
+    return items
+
+
+def encode(items):
+    out = bytearray(MAGIC)
+    out += struct.pack("<BBH", VERSION, 0, len(items))
+    for title, description in items:
+        t = title.encode("ascii")
+        d = description.encode("ascii")
+        out += struct.pack("<BBBBI", classify(title, description), len(t), len(d), 0,
+                           item_hash(title, description))
+        out += t + d
+    return bytes(out)
+
+
+def decode(data):
+    if data[:4] != MAGIC:
+        raise ValueError("not a scroller feed")
+    version, _flags, count = struct.unpack_from("<BBH", data, 4)
+    if version != VERSION:
+        raise ValueError("unsupported version %d" % version)
+    pos = 8
+    items = []
+    for _ in range(count):
+        flags, t_len, d_len, _reserved, h = struct.unpack_from("<BBBBI", data, pos)
+        pos += 8
+        title = data[pos:pos + t_len].decode("ascii")
+        pos += t_len
+        description = data[pos:pos + d_len].decode("ascii")
+        pos += d_len
+        items.append({"flags": flags, "hash": h, "title": title, "description": description})
+    return items
+
+
+def wants_scroller_feed(handler, query):
+    if query.get("fmt", [""])[0] == "scroller":
+        return True
+    return CONTENT_TYPE in handler.headers.get("Accept", "")
+
+
+def make_handler(corpus_dir):
+    class FeedHandler(BaseHTTPRequestHandler):
+        def do_GET(self):
+            url = urlparse(self.path)
+            query = parse_qs(url.query)
+            if url.path.endswith(".json"):
+                self.send_file(os.path.join(corpus_dir, os.path.basename(url.path)), "application/json")
+                return
+            name = query.get("sport", [os.path.splitext(os.path.basename(url.path))[0]])[0]
+            path = os.path.join(corpus_dir, name + ".xml")
+            if not name or not os.path.isfile(path):
+                self.send_error(404, "no corpus file for '%s'" % name)
+                return
+
+            with open(path, "rb") as fp:
+                body = fp.read()
+            content_type = "application/rss+xml"
+            if wants_scroller_feed(self, query):
+                body = encode(parse_rss(body))
+                content_type = CONTENT_TYPE
+
+            self.send_body(body, content_type)
+
+        def send_file(self, path, content_type):
+            if not os.path.isfile(path):
+                self.send_error(404, "no corpus file '%s'" % os.path.basename(path))
+                return
+            with open(path, "rb") as fp:
+                self.send_body(fp.read(), content_type)
+
+        def send_body(self, body, content_type):
+            self.send_response(200)
+            self.send_header("Content-Type", content_type)
+            self.send_header("Content-Length", str(len(body)))
+            self.end_headers()
+            self.wfile.write(body)
+
+    return FeedHandler
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    sub = parser.add_subparsers(dest="cmd", required=True)
+
+    p_enc = sub.add_parser("encode", help="convert an RSS file to the scroller feed format")
+    p_enc.add_argument("input")
+    p_enc.add_argument("output")
+
+    p_dec = sub.add_parser("decode", help="print the items in a scroller feed file")
+    p_dec.add_argument("input")
+
+    p_srv = sub.add_parser("serve", help="serve a directory of RSS files as RSS or scroller feeds")
+    p_srv.add_argument("--dir", default=".")
+    p_srv.add_argument("--port", type=int, default=8080)
+
+    args = parser.parse_args()
+
+    if args.cmd == "encode":
+        with open(args.input, "rb") as fp:
+            data = encode(parse_rss(fp.read()))
+        with open(args.output, "wb") as fp:
+            fp.write(data)
+        print("wrote %d bytes" % len(data))
+    elif args.cmd == "decode":
+        with open(args.input, "rb") as fp:
+            for item in decode(fp.read()):
+                print("[%02x %08x] %s | %s" % (item["flags"], item["hash"], item["title"], item["description"]))
+    elif args.cmd == "serve":
+        server = ThreadingHTTPServer(("", args.port), make_handler(args.dir))
+        print("serving %s on port %d" % (os.path.abspath(args.dir), args.port))
+        try:
+            server.serve_forever()
+        except KeyboardInterrupt:
+            pass
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
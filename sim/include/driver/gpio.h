@@ -0,0 +1,24 @@
+#ifndef SIM_GPIO_H
+#define SIM_GPIO_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef struct {
+    uint64_t pin_bit_mask;
+    int mode;
+    int pull_up_en;
+    int pull_down_en;
+    int intr_type;
+} gpio_config_t;
+
+#define GPIO_MODE_INPUT       1
+#define GPIO_PULLUP_ENABLE    1
+#define GPIO_PULLDOWN_DISABLE 0
+#define GPIO_INTR_NEGEDGE     2
+
+esp_err_t gpio_config(const gpio_config_t *conf);
+esp_err_t gpio_install_isr_service(int flags);
+esp_err_t gpio_isr_handler_add(int gpio_num, void (*handler)(void *), void *arg);
+
+#endif
@@ -0,0 +1,9 @@
+#ifndef SIM_ESP_RANDOM_H
+#define SIM_ESP_RANDOM_H
+
+#include <stdint.h>
+
+// Seeded PRNG so runs are reproducible (--seed).
+uint32_t esp_random(void);
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef SIM_FREERTOS_H
+#define SIM_FREERTOS_H
+
+// Host stand-in for the FreeRTOS API the firmware uses. Tasks are
+// coroutines on one host thread, scheduled by virtual time (sim_rtos.c).
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+
+#define pdTRUE  1
+#define pdFALSE 0
+#define pdPASS  1
+#define pdFAIL  0
+
+#define portMAX_DELAY      0xffffffffu
+#define configTICK_RATE_HZ 100   // CONFIG_FREERTOS_HZ in sdkconfig
+#define portTICK_PERIOD_MS (1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(ms)  ((TickType_t)((uint64_t)(ms) * configTICK_RATE_HZ / 1000))
+#define pdTICKS_TO_MS(t)   ((uint32_t)((uint64_t)(t) * 1000 / configTICK_RATE_HZ))
+
+#define IRAM_ATTR
+
+// One host thread runs all tasks and nothing preempts them, so critical
+// sections have nothing to exclude.
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux)  ((void)(mux))
+#define tskNO_AFFINITY 0x7fffffff
+
+#define BIT0 (1u << 0)
+#define BIT1 (1u << 1)
+#define BIT2 (1u << 2)
+#define BIT3 (1u << 3)
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef SIM_HEAP_H
+#define SIM_HEAP_H
+
+// Model of the device heap: a fixed-size first-fit allocator with
+// coalescing, so fragmentation and failed allocations show up the way they
+// would on the target. Firmware and littlefs sources reach it through the
+// malloc() macros in sim_port.h; simulator code calls it directly for
+// allocations the device would make (task stacks, HTTP and TLS buffers).
+
+#include <stddef.h>
+
+typedef struct {
+    size_t total;
+    size_t free;
+    size_t min_free;          // lowest free since init
+    size_t largest_free;      // largest single free block now
+    size_t min_largest_free;  // lowest largest_free seen at a sample
+    size_t blocks_used;
+    size_t blocks_free;
+    unsigned failures;        // allocations that could not be satisfied
+} sim_heap_stats_t;
+
+void sim_heap_init(size_t size);
+void *sim_malloc(size_t size);
+void *sim_calloc(size_t n, size_t size);
+void *sim_realloc(void *p, size_t size);
+void sim_free(void *p);
+char *sim_strdup(const char *s);
+
+// Fill out; also folds the current largest free block into min_largest_free.
+void sim_heap_sample(sim_heap_stats_t *out);
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef SIM_PORT_H
+#define SIM_PORT_H
+
+// Force-included into every firmware source built by the simulator. Heap
+// calls go to the heap model, file calls to littlefs on the emulated flash
+// (sim_flash.c), and time() to the virtual clock.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include "sim_heap.h"
+
+typedef struct sim_file SIM_FILE;
+
+SIM_FILE *sim_fopen(const char *path, const char *mode);
+size_t sim_fread(void *buf, size_t size, size_t count, SIM_FILE *fp);
+size_t sim_fwrite(const void *buf, size_t size, size_t count, SIM_FILE *fp);
+int sim_fseek(SIM_FILE *fp, long offset, int whence);
+int sim_fclose(SIM_FILE *fp);
+int sim_remove(const char *path);
+int sim_rename(const char *from, const char *to);
+int sim_mkdir(const char *path, mode_t mode);
+time_t sim_time(time_t *out);
+
+#define malloc(n)          sim_malloc(n)
+#define calloc(n, s)       sim_calloc(n, s)
+#define realloc(p, n)      sim_realloc(p, n)
+#define free(p)            sim_free(p)
+#define strdup(s)          sim_strdup(s)
+
+#define FILE               SIM_FILE
+#define fopen(p, m)        sim_fopen(p, m)
+#define fread(b, s, n, f)  sim_fread(b, s, n, f)
+#define fwrite(b, s, n, f) sim_fwrite(b, s, n, f)
+#define fseek(f, o, w)     sim_fseek(f, o, w)
+#define fclose(f)          sim_fclose(f)
+#define remove(p)          sim_remove(p)
+#define rename(a, b)       sim_rename(a, b)
+#define mkdir(p, m)        sim_mkdir(p, m)
+#define time(t)            sim_time(t)
+
+#endif
@@ -0,0 +1,520 @@
+// Parser bench: runs the fetcher's RSS, JSON and scroller-feed decoders over
+// one generated corpus (the same items in each encoding), checks that they
+// produce identical items, and times them. Then checks the streaming JSON
+// tokenizer on the inputs that break parsers: truncated documents, keys
+// longer than JSON_STREAM_MAX_KEY, escapes and nesting past the depth limit,
+// each fed whole and one byte at a time. Bodies are served from memory in
+// network-sized segments, so the timings are parse cost only.
+//
+//   make -C sim && sim/build/parser_bench --iterations 2000
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+#include <getopt.h>
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_http_client.h"
+#include "esp_crt_bundle.h"
+#include "rss_fetcher.h"
+#include "json_stream.h"
+#include "trace.h"
+
+#define BENCH_ITEMS       24   // under RSS_MAX_ITEMS, so every body is read to EOF
+#define BENCH_OVER_ITEMS  (RSS_MAX_ITEMS + 10)
+#define BENCH_SEGMENT     1436
+#define BENCH_BODY_SIZE   (64 * 1024)
+
+#define JSON_TITLE_PATH "events[].name"
+#define JSON_DESC_PATH  "events[].status.type.detail"
+
+static int failures;
+static bool verbose;
+
+#define CHECK(cond, ...)                                  \
+    do {                                                  \
+        if (!(cond)) {                                    \
+            failures++;                                   \
+            printf("FAIL %s:%d: ", __FILE__, __LINE__);   \
+            printf(__VA_ARGS__);                          \
+            putchar('\n');                                \
+        }                                                 \
+    } while (0)
+
+// ── Firmware stand-ins ──
+
+int64_t esp_timer_get_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void sim_log(esp_log_level_t level, const char *tag, const char *fmt, ...)
+{
+    if (!verbose || level > ESP_LOG_WARN) return;
+    printf("  %c %s: ", level == ESP_LOG_ERROR ? 'E' : 'W', tag);
+    va_list args;
+    va_start(args, fmt);
+    vprintf(fmt, args);
+    va_end(args);
+    putchar('\n');
+}
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+    case ESP_OK:                   return "ESP_OK";
+    case ESP_FAIL:                 return "ESP_FAIL";
+    case ESP_ERR_INVALID_SIZE:     return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_INVALID_RESPONSE: return "ESP_ERR_INVALID_RESPONSE";
+    case ESP_ERR_INVALID_VERSION:  return "ESP_ERR_INVALID_VERSION";
+    default:                       return "UNKNOWN ERROR";
+    }
+}
+
+void trace_begin(trace_cat_t cat, const char *name, int32_t arg) {}
+void trace_end(trace_cat_t cat, const char *name, int32_t arg) {}
+void trace_instant(trace_cat_t cat, const char *name, int32_t arg) {}
+
+esp_err_t esp_crt_bundle_attach(void *conf)
+{
+    return ESP_OK;
+}
+
+// ── In-memory esp_http_client ──
+
+// Every request gets the current body, in segments of at most body_segment.
+static const char *body;
+static size_t body_len;
+static size_t body_segment = BENCH_SEGMENT;
+
+struct esp_http_client {
+    size_t pos;
+};
+
+esp_http_client_handle_t esp_http_client_init(const esp_http_client_config_t *config)
+{
+    return calloc(1, sizeof(struct esp_http_client));
+}
+
+esp_err_t esp_http_client_set_header(esp_http_client_handle_t c, const char *key,
+                                     const char *value)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_open(esp_http_client_handle_t c, int write_len)
+{
+    c->pos = 0;
+    return ESP_OK;
+}
+
+int64_t esp_http_client_fetch_headers(esp_http_client_handle_t c)
+{
+    return (int64_t)body_len;
+}
+
+int esp_http_client_get_status_code(esp_http_client_handle_t c)
+{
+    return 200;
+}
+
+esp_err_t esp_http_client_set_redirection(esp_http_client_handle_t c)
+{
+    return ESP_OK;
+}
+
+int esp_http_client_read(esp_http_client_handle_t c, char *buf, int len)
+{
+    size_t n = body_len - c->pos;
+    if (n > (size_t)len) n = (size_t)len;
+    if (n > body_segment) n = body_segment;
+    memcpy(buf, body + c->pos, n);
+    c->pos += n;
+    return (int)n;
+}
+
+bool esp_http_client_is_complete_data_received(esp_http_client_handle_t c)
+{
+    return c->pos >= body_len;
+}
+
+esp_err_t esp_http_client_close(esp_http_client_handle_t c)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t c)
+{
+    free(c);
+    return ESP_OK;
+}
+
+// ── Corpus ──
+
+typedef enum {
+    CORPUS_RSS,
+    CORPUS_JSON,
+    CORPUS_SCROLLER,
+    CORPUS_FORMAT_COUNT,
+} corpus_format_t;
+
+static const char *const format_names[CORPUS_FORMAT_COUNT] = {"rss", "json", "scroller"};
+
+// What every encoding must decode to.
+static void expected_item(int i, char *title, size_t title_size, char *desc, size_t desc_size)
+{
+    snprintf(title, title_size, "Storm & rain - \"late\" update #%d", i);
+    snprintf(desc, desc_size, "Crews <cleared> %d roads; the harbor bridge reopens at 6 - "
+             "officials say it's the council's call...", i * 7);
+}
+
+static uint32_t item_hash(const char *title, const char *desc)
+{
+    uint32_t hash = 2166136261u;
+    for (const char *p = title; *p; p++) {
+        hash ^= (uint8_t)*p;
+        hash *= 16777619u;
+    }
+    hash ^= 0x1Fu;
+    hash *= 16777619u;
+    for (const char *p = desc; *p; p++) {
+        hash ^= (uint8_t)*p;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static size_t render_rss(char *out, size_t size, int items)
+{
+    size_t len = (size_t)snprintf(out, size,
+                                  "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                                  "<rss version=\"2.0\"><channel><title>Bench</title>\n");
+    for (int i = 0; i < items; i++) {
+        // Entities, CDATA, markup and a UTF-8 em dash, as real feeds mix them.
+        len += (size_t)snprintf(out + len, size - len,
+                                "<item><title>Storm &amp; rain \xE2\x80\x94 &quot;late&quot; "
+                                "update #%d</title><link>https://feeds.sim/%d</link>"
+                                "<description><![CDATA[<p>Crews &lt;cleared&gt; %d roads; "
+                                "the <b>harbor</b> bridge reopens at 6 &ndash; officials say "
+                                "it&#39;s the council&rsquo;s call&hellip;</p>]]></description>"
+                                "</item>\n",
+                                i, i, i * 7);
+    }
+    len += (size_t)snprintf(out + len, size - len, "</channel></rss>\n");
+    return len;
+}
+
+static size_t render_json(char *out, size_t size, int items)
+{
+    size_t len = (size_t)snprintf(out, size, "{\"league\":\"Bench\",\"events\":[");
+    for (int i = 0; i < items; i++) {
+        len += (size_t)snprintf(out + len, size - len,
+                                "%s{\"id\":%d,\"name\":\"Storm & rain \\u2014 \\\"late\\\" "
+                                "update #%d\",\"links\":[{\"href\":\"https:\\/\\/feeds.sim\\/%d\"}],"
+                                "\"status\":{\"type\":{\"detail\":\"Crews <cleared> %d roads; "
+                                "the harbor bridge reopens at 6 \\u2013 officials say it's the "
+                                "council\\u2019s call\\u2026\",\"completed\":false}}}",
+                                i ? "," : "", i, i, i, i * 7);
+    }
+    len += (size_t)snprintf(out + len, size - len, "]}");
+    return len;
+}
+
+static void put_le16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_le32(uint8_t *p, uint32_t v)
+{
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+// Same layout as scripts/scroller_feed.py: "MCSF", version, flags, u16 count,
+// then per item flags, title_len, desc_len, reserved, u32 hash, title, desc.
+static size_t render_scroller(char *out, size_t size, int items)
+{
+    uint8_t *p = (uint8_t *)out;
+    memcpy(p, "MCSF", 4);
+    p[4] = 1;
+    p[5] = 0;
+    put_le16(p + 6, (uint16_t)items);
+    size_t len = 8;
+    for (int i = 0; i < items; i++) {
+        char title[RSS_TITLE_LEN + 1];
+        char desc[RSS_DESC_LEN + 1];
+        expected_item(i, title, sizeof(title), desc, sizeof(desc));
+        size_t title_len = strlen(title);
+        size_t desc_len = strlen(desc);
+        if (len + 8 + title_len + desc_len > size) break;
+        p[len] = 0;
+        p[len + 1] = (uint8_t)title_len;
+        p[len + 2] = (uint8_t)desc_len;
+        p[len + 3] = 0;
+        put_le32(p + len + 4, item_hash(title, desc));
+        memcpy(p + len + 8, title, title_len);
+        memcpy(p + len + 8 + title_len, desc, desc_len);
+        len += 8 + title_len + desc_len;
+    }
+    return len;
+}
+
+static size_t render(corpus_format_t format, char *out, size_t size, int items)
+{
+    switch (format) {
+    case CORPUS_RSS:  return render_rss(out, size, items);
+    case CORPUS_JSON: return render_json(out, size, items);
+    default:          return render_scroller(out, size, items);
+    }
+}
+
+static esp_err_t fetch(corpus_format_t format, const char *doc, size_t len)
+{
+    rss_fetch_options_t options = {0};
+    if (format == CORPUS_JSON) {
+        options.json_title_path = JSON_TITLE_PATH;
+        options.json_desc_path = JSON_DESC_PATH;
+    }
+    body = doc;
+    body_len = len;
+    return rss_fetch_ex("https://feeds.sim/bench", &options);
+}
+
+// ── Fetcher checks ──
+
+static void check_items(corpus_format_t format, int expected_count)
+{
+    const char *name = format_names[format];
+    CHECK(rss_get_count() == expected_count, "%s: %d items, expected %d", name,
+          rss_get_count(), expected_count);
+    for (int i = 0; i < rss_get_count() && i < expected_count; i++) {
+        char title[RSS_TITLE_LEN + 1];
+        char desc[RSS_DESC_LEN + 1];
+        expected_item(i, title, sizeof(title), desc, sizeof(desc));
+        const rss_item_t *item = rss_get_item(i);
+        CHECK(strcmp(item->title, title) == 0, "%s item %d title: \"%s\"", name, i, item->title);
+        CHECK(strcmp(item->description, desc) == 0, "%s item %d description: \"%s\"", name, i,
+              item->description);
+        CHECK(item->hash == item_hash(title, desc), "%s item %d hash %08x", name, i,
+              (unsigned)item->hash);
+    }
+}
+
+static void check_corpus(char *doc)
+{
+    static const size_t segments[] = {1, 7, 512, BENCH_SEGMENT};
+
+    for (int f = 0; f < CORPUS_FORMAT_COUNT; f++) {
+        size_t len = render((corpus_format_t)f, doc, BENCH_BODY_SIZE, BENCH_ITEMS);
+        for (size_t s = 0; s < sizeof(segments) / sizeof(segments[0]); s++) {
+            body_segment = segments[s];
+            esp_err_t err = fetch((corpus_format_t)f, doc, len);
+            CHECK(err == ESP_OK, "%s in %zu-byte segments: %s", format_names[f], segments[s],
+                  esp_err_to_name(err));
+            check_items((corpus_format_t)f, BENCH_ITEMS);
+        }
+        body_segment = BENCH_SEGMENT;
+
+        // A longer document stops at the item limit without reading to EOF.
+        len = render((corpus_format_t)f, doc, BENCH_BODY_SIZE, BENCH_OVER_ITEMS);
+        esp_err_t err = fetch((corpus_format_t)f, doc, len);
+        CHECK(err == ESP_OK, "%s past the item limit: %s", format_names[f], esp_err_to_name(err));
+        check_items((corpus_format_t)f, RSS_MAX_ITEMS);
+    }
+}
+
+static void check_truncated_bodies(char *doc)
+{
+    size_t len = render_scroller(doc, BENCH_BODY_SIZE, BENCH_ITEMS);
+    esp_err_t err = fetch(CORPUS_SCROLLER, doc, len - 5);
+    CHECK(err == ESP_ERR_INVALID_SIZE && rss_get_count() == 0,
+          "scroller feed cut mid-record: %s, %d items", esp_err_to_name(err), rss_get_count());
+    err = fetch(CORPUS_SCROLLER, doc, 6);
+    CHECK(err == ESP_ERR_INVALID_SIZE, "scroller feed cut in its header: %s",
+          esp_err_to_name(err));
+
+    // Records end on a boundary but fewer than the header promised.
+    put_le16((uint8_t *)doc + 6, BENCH_ITEMS + 1);
+    err = fetch(CORPUS_SCROLLER, doc, len);
+    CHECK(err == ESP_ERR_INVALID_SIZE, "scroller feed missing a record: %s",
+          esp_err_to_name(err));
+
+    // Past the item limit the rest of the body is never needed.
+    len = render_scroller(doc, BENCH_BODY_SIZE, BENCH_OVER_ITEMS);
+    err = fetch(CORPUS_SCROLLER, doc, len - 5);
+    CHECK(err == ESP_OK && rss_get_count() == RSS_MAX_ITEMS,
+          "scroller feed cut after the item limit: %s, %d items", esp_err_to_name(err),
+          rss_get_count());
+
+    len = render_json(doc, BENCH_BODY_SIZE, BENCH_ITEMS);
+    err = fetch(CORPUS_JSON, doc, len / 2);
+    CHECK(err == ESP_ERR_INVALID_RESPONSE && rss_get_count() == 0, "JSON feed cut in half: %s",
+          esp_err_to_name(err));
+}
+
+// ── Tokenizer checks ──
+
+typedef struct {
+    char log[2048];
+    size_t len;
+} event_log_t;
+
+static bool log_event(void *ctx, json_stream_event_t event, const char *path,
+                      const char *value, int value_len)
+{
+    static const char marks[] = "{}[]snTFN";
+    event_log_t *log = (event_log_t *)ctx;
+    int n = snprintf(log->log + log->len, sizeof(log->log) - log->len, "%c %s=%s|",
+                     marks[event], path, value);
+    if (n > 0 && log->len + (size_t)n < sizeof(log->log)) log->len += (size_t)n;
+    return true;
+}
+
+// Tokenize doc whole and a byte at a time; both must agree on events and status.
+static json_stream_status_t tokenize(const char *doc, event_log_t *log)
+{
+    json_stream_t *js = malloc(sizeof(*js));
+    size_t len = strlen(doc);
+    json_stream_status_t status[2];
+    event_log_t logs[2] = {0};
+
+    for (int pass = 0; pass < 2; pass++) {
+        json_stream_init(js, log_event, &logs[pass]);
+        if (pass == 0) {
+            json_stream_feed(js, doc, len);
+        } else {
+            for (size_t i = 0; i < len; i++) json_stream_feed(js, doc + i, 1);
+        }
+        status[pass] = json_stream_finish(js);
+    }
+    free(js);
+
+    CHECK(status[0] == status[1] && strcmp(logs[0].log, logs[1].log) == 0,
+          "byte-at-a-time tokenizing differs for %.40s", doc);
+    if (log) *log = logs[0];
+    return status[0];
+}
+
+static void expect_events(const char *doc, const char *expected)
+{
+    event_log_t log;
+    json_stream_status_t status = tokenize(doc, &log);
+    CHECK(status == JSON_STREAM_OK, "%.40s: status %d", doc, status);
+    CHECK(strcmp(log.log, expected) == 0, "%.40s:\n  got      %s\n  expected %s", doc, log.log,
+          expected);
+}
+
+static void expect_error(const char *doc)
+{
+    CHECK(tokenize(doc, NULL) == JSON_STREAM_ERROR, "%.60s: expected an error", doc);
+}
+
+static void check_tokenizer(void)
+{
+    char doc[512];
+    char key[JSON_STREAM_MAX_KEY + 2];
+    char expected[512];
+
+    expect_error("");
+    expect_error("{\"a\":[1,2");
+    expect_error("{\"a\":\"unterminated");
+    expect_error("{\"a\":\"\\u00");
+    expect_error("{\"a\":tru");
+    expect_error("{\"a\" 1}");
+    expect_error("{\"a\":1]");
+    expect_error("{\"a\":1} x");
+    expect_error("[1,\"\\u12g4\"]");
+    expect_events("42", "n =42|");
+
+    expect_events("{\"t\":\"q\\\"b\\\\s\\/n\\n\\u0041\\u00e9\\u20ac\\ud83d\\ude00\"}",
+                  "{ =|s t=q\"b\\s/n\nA\xC3\xA9\xE2\x82\xAC??|} =|");
+
+    // A key that fits is kept; one past the limit must not alias its prefix.
+    memset(key, 'k', JSON_STREAM_MAX_KEY);
+    key[JSON_STREAM_MAX_KEY] = '\0';
+    snprintf(doc, sizeof(doc), "{\"%s\":1,\"%sx\":{\"name\":\"b\"},\"name\":\"c\"}", key, key);
+    snprintf(expected, sizeof(expected),
+             "{ =|n %s=1|{ ~=|s ~.name=b|} ~=|s name=c|} =|", key);
+    expect_events(doc, expected);
+
+    // JSON_STREAM_MAX_DEPTH containers nest; one more is an error.
+    size_t n = 0;
+    for (int i = 0; i < JSON_STREAM_MAX_DEPTH; i++) doc[n++] = '[';
+    for (int i = 0; i < JSON_STREAM_MAX_DEPTH; i++) doc[n++] = ']';
+    doc[n] = '\0';
+    CHECK(tokenize(doc, NULL) == JSON_STREAM_OK, "%d nested arrays rejected", JSON_STREAM_MAX_DEPTH);
+    n = 0;
+    for (int i = 0; i <= JSON_STREAM_MAX_DEPTH; i++) doc[n++] = '[';
+    for (int i = 0; i <= JSON_STREAM_MAX_DEPTH; i++) doc[n++] = ']';
+    doc[n] = '\0';
+    expect_error(doc);
+
+    // Long values are cut at JSON_STREAM_MAX_VALUE; the document still parses.
+    n = (size_t)snprintf(doc, sizeof(doc), "[\"");
+    for (int i = 0; i < JSON_STREAM_MAX_VALUE + 20; i++) doc[n++] = 'v';
+    n += (size_t)snprintf(doc + n, sizeof(doc) - n, "\"]");
+    event_log_t log;
+    CHECK(tokenize(doc, &log) == JSON_STREAM_OK, "long value rejected");
+    CHECK(strlen(log.log) == strlen("[ =|s []=|] =|") + JSON_STREAM_MAX_VALUE,
+          "long value not cut at %d bytes", JSON_STREAM_MAX_VALUE);
+}
+
+// ── Bench ──
+
+static void bench(char *doc, int iterations)
+{
+    printf("%-9s %7s %7s %10s %8s\n", "format", "items", "bytes", "us/doc", "MB/s");
+    for (int f = 0; f < CORPUS_FORMAT_COUNT; f++) {
+        size_t len = render((corpus_format_t)f, doc, BENCH_BODY_SIZE, BENCH_ITEMS);
+        int64_t start = esp_timer_get_time();
+        for (int i = 0; i < iterations; i++) fetch((corpus_format_t)f, doc, len);
+        double us = (double)(esp_timer_get_time() - start) / iterations;
+        printf("%-9s %7d %7zu %10.1f %8.1f\n", format_names[f], rss_get_count(), len, us,
+               us > 0 ? len / us : 0.0);
+    }
+}
+
+static void usage(const char *prog)
+{
+    printf("usage: %s [options]\n"
+           "  --iterations N  fetches per format for the timings (default 2000; 0 skips them)\n"
+           "  --verbose       print the fetcher's warnings and errors\n",
+           prog);
+}
+
+int main(int argc, char **argv)
+{
+    static const struct option options[] = {
+        {"iterations", required_argument, NULL, 'i'},
+        {"verbose", no_argument, NULL, 'v'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0},
+    };
+    int iterations = 2000;
+    int opt;
+    while ((opt = getopt_long(argc, argv, "", options, NULL)) != -1) {
+        switch (opt) {
+        case 'i': iterations = atoi(optarg); break;
+        case 'v': verbose = true; break;
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    char *doc = malloc(BENCH_BODY_SIZE);
+    check_corpus(doc);
+    check_truncated_bodies(doc);
+    check_tokenizer();
+    if (iterations > 0) bench(doc, iterations);
+    free(doc);
+
+    printf("%s: %d check%s failed\n", failures ? "FAIL" : "ok", failures, failures == 1 ? "" : "s");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,126 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Shared state of the soak simulator. Simulator sources are built without
+// sim_port.h, so their own bookkeeping uses the host heap; allocations the
+// device would make go through sim_malloc() explicitly.
+
+#define SIM_MAX_SOURCES 8
+#define SIM_US_PER_HOUR (3600LL * 1000000)
+#define SIM_US_PER_DAY  (24 * SIM_US_PER_HOUR)
+
+// ── Virtual clock and tasks (sim_rtos.c) ──
+
+int64_t sim_now_us(void);
+
+// Block the calling task for us of virtual time; other tasks run meanwhile.
+void sim_sleep_us(int64_t us);
+
+// Run tasks until virtual time reaches end_us. Calls tick() whenever the
+// clock crosses a multiple of tick_period_us.
+void sim_run(int64_t end_us, int64_t tick_period_us, void (*tick)(int64_t now_us));
+
+// Network-model randomness, kept apart from the firmware's esp_random().
+void sim_seed(uint32_t seed);
+uint32_t sim_rand(void);
+// Uniform in [lo, hi].
+int64_t sim_rand_range(int64_t lo, int64_t hi);
+
+// ── Scenario (soak.c) ──
+
+typedef struct {
+    char name[24];
+    bool json;               // JSON document instead of RSS
+    int items;               // items in the feed document
+    int change_min;          // minutes between content changes
+    int new_per_change;      // items added to the top at each change
+    int fail_pct;            // share of requests that time out
+    int outage_start_h;      // scripted outage, hours from boot (-1 = none)
+    int outage_hours;
+} sim_source_cfg_t;
+
+typedef struct {
+    int days;
+    uint32_t seed;
+    size_t heap_bytes;
+    bool background_refresh;
+    int refresh_budget_s;
+    int speed;
+    int panel_cols;
+    int wifi_outage_start_h;  // -1 = none
+    int wifi_outage_hours;
+    bool verbose;
+    int source_count;
+    sim_source_cfg_t sources[SIM_MAX_SOURCES];
+} sim_scenario_t;
+
+extern sim_scenario_t sim_scenario;
+
+// ── Feed corpus and network (sim_feeds.c) ──
+
+// URL of source i as configured in the firmware settings.
+void sim_source_url(int i, char *out, size_t size);
+
+// Decode a headline produced by the corpus: its source and the virtual
+// time it was published. False for text the corpus did not generate.
+bool sim_parse_headline(const char *text, int *source, int64_t *published_us);
+
+bool sim_wifi_outage(int64_t now_us);
+
+// ── Statistics (soak.c) ──
+
+typedef struct {
+    double *v;
+    size_t len;
+    size_t cap;
+} sim_series_t;
+
+void sim_series_add(sim_series_t *s, double value);
+
+typedef struct {
+    // display
+    unsigned headlines;
+    unsigned source_shows[SIM_MAX_SOURCES];
+    double expected_share[SIM_MAX_SOURCES];  // sum over shows of cached share
+    sim_series_t age_s;                       // headline age when shown
+    sim_series_t repeat_gap;                  // shows between repeats / pool size
+    unsigned cached_items[SIM_MAX_SOURCES];   // items in each cache file
+
+    // refresh
+    sim_series_t refresh_ms;
+    sim_series_t fetch_ms[SIM_MAX_SOURCES];
+    unsigned fetch_failures[SIM_MAX_SOURCES];
+    uint64_t fetch_bytes[SIM_MAX_SOURCES];
+    unsigned radio_ons;
+    unsigned radio_failures;
+    int64_t radio_on_us;
+
+    // storage
+    uint64_t littlefs_app_bytes;  // bytes the firmware asked to write
+    uint64_t nvs_bytes;
+
+    // logs
+    unsigned errors;
+    unsigned warnings;
+} sim_stats_t;
+
+extern sim_stats_t sim_stats;
+
+// ── Flash (sim_flash.c) ──
+
+typedef struct {
+    uint64_t read_bytes;
+    uint64_t prog_bytes;
+    uint64_t erase_bytes;
+    uint32_t max_block_erases;
+    uint32_t blocks;
+    uint32_t used_blocks;
+} sim_flash_stats_t;
+
+void sim_flash_get_stats(sim_flash_stats_t *out);
+
+#endif
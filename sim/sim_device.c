@@ -0,0 +1,412 @@
+// Stand-ins for the parts of the firmware the soak run does not exercise
+// (LED output, font, web server, realtime input, WiFi driver, NVS) and the
+// hooks it observes through: settings built from the scenario, a scroller
+// that records what reaches the panel, and metrics/trace collectors.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include "sim.h"
+#include "sim_heap.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "nvs_flash.h"
+#include "driver/gpio.h"
+#include "settings.h"
+#include "text_scroller.h"
+#include "led_panel.h"
+#include "font.h"
+#include "wifi_manager.h"
+#include "web_server.h"
+#include "realtime_ingest.h"
+#include "rss_fetcher.h"
+#include "metrics.h"
+#include "trace.h"
+#include "deferred_log.h"
+
+// text_scroller.c: 16 ms frames, Q8 pixels per frame by speed, 5 px glyphs
+// plus a 1 px gap.
+#define SCROLLER_FRAME_MS 16
+#define SCROLLER_CHAR_PX  6
+static const uint16_t speed_px_per_frame_q8[10] = {56, 72, 92, 116, 144, 176, 212, 252, 296, 344};
+
+// WiFi association after radio_on(): fast path (cached BSSID/channel) most
+// of the time, a full scan otherwise.
+#define WIFI_JOIN_MIN_MS  300
+#define WIFI_JOIN_MAX_MS  1500
+#define WIFI_JOIN_FAIL_MS 5000
+
+// ── Settings ──
+
+static app_settings_t settings;
+
+esp_err_t settings_init(void)
+{
+    memset(&settings, 0, sizeof(settings));
+    snprintf(settings.messages[0].text, sizeof(settings.messages[0].text), "Soak test");
+    settings.messages[0].enabled = true;
+    settings.messages[0].color_r = 255;
+    settings.speed = (uint8_t)sim_scenario.speed;
+    settings.brightness = 32;
+    settings.panel_cols = (uint8_t)sim_scenario.panel_cols;
+    settings.rss_enabled = true;
+    settings.rss_refresh_budget_s = (uint8_t)sim_scenario.refresh_budget_s;
+    settings.rss_background_refresh = sim_scenario.background_refresh;
+    settings.rss_source_count = (uint8_t)sim_scenario.source_count;
+    for (int i = 0; i < sim_scenario.source_count; i++) {
+        rss_source_t *src = &settings.rss_sources[i];
+        src->enabled = true;
+        snprintf(src->name, sizeof(src->name), "%s", sim_scenario.sources[i].name);
+        sim_source_url(i, src->url, sizeof(src->url));
+        src->type = sim_scenario.sources[i].json ? RSS_SOURCE_TYPE_JSON : RSS_SOURCE_TYPE_RSS;
+        if (src->type == RSS_SOURCE_TYPE_JSON) {
+            snprintf(src->json_title_path, sizeof(src->json_title_path), "events[].name");
+            snprintf(src->json_desc_path, sizeof(src->json_desc_path),
+                     "events[].status.type.detail");
+        }
+    }
+    return ESP_OK;
+}
+
+const app_settings_t *settings_acquire(void)
+{
+    return &settings;
+}
+
+void settings_release(const app_settings_t *s)
+{
+    (void)s;
+}
+
+uint32_t settings_get_generation(void)
+{
+    return 0;
+}
+
+esp_err_t settings_subscribe(settings_change_cb_t cb, void *ctx)
+{
+    (void)cb;
+    (void)ctx;
+    return ESP_OK;
+}
+
+esp_err_t settings_flush(void)
+{
+    return ESP_OK;
+}
+
+// ── Scroller ──
+
+typedef struct {
+    int64_t *last_show;   // headline index of the last show, by serial (+1; 0 = never)
+    size_t len;
+} shown_serials_t;
+
+static shown_serials_t shown[SIM_MAX_SOURCES];
+static char scroller_text[SCROLLER_MAX_TEXT_LEN + 1];
+static uint8_t scroller_speed = 5;
+
+static unsigned cached_pool(void)
+{
+    unsigned total = 0;
+    for (int i = 0; i < sim_scenario.source_count; i++) total += sim_stats.cached_items[i];
+    return total;
+}
+
+static void record_headline(const char *text)
+{
+    int source;
+    int64_t published_us;
+    if (!sim_parse_headline(text, &source, &published_us)) return;
+
+    const char *hash = strstr(text, " #");
+    size_t serial = strtoul(hash + 2, NULL, 10);
+    shown_serials_t *s = &shown[source];
+    if (serial >= s->len) {
+        size_t len = s->len ? s->len : 256;
+        while (len <= serial) len *= 2;
+        s->last_show = realloc(s->last_show, len * sizeof(*s->last_show));
+        memset(s->last_show + s->len, 0, (len - s->len) * sizeof(*s->last_show));
+        s->len = len;
+    }
+
+    unsigned pool = cached_pool();
+    if (s->last_show[serial] && pool > 0) {
+        double gap = (double)(sim_stats.headlines - (s->last_show[serial] - 1));
+        sim_series_add(&sim_stats.repeat_gap, gap / pool);
+    }
+    s->last_show[serial] = (int64_t)sim_stats.headlines + 1;
+
+    sim_stats.headlines++;
+    sim_stats.source_shows[source]++;
+    for (int i = 0; pool > 0 && i < sim_scenario.source_count; i++) {
+        sim_stats.expected_share[i] += (double)sim_stats.cached_items[i] / pool;
+    }
+    sim_series_add(&sim_stats.age_s, (double)(sim_now_us() - published_us) / 1e6);
+}
+
+void scroller_init(void) {}
+
+void scroller_set_text(const char *text)
+{
+    snprintf(scroller_text, sizeof(scroller_text), "%s", text);
+    record_headline(scroller_text);
+    if (sim_scenario.verbose) {
+        sim_log(ESP_LOG_INFO, "scroller", "Text set to: %s", scroller_text);
+    }
+}
+
+void scroller_set_color(uint8_t r, uint8_t g, uint8_t b)
+{
+    (void)r;
+    (void)g;
+    (void)b;
+}
+
+void scroller_set_speed(uint8_t speed)
+{
+    if (speed < 1) speed = 1;
+    if (speed > 10) speed = 10;
+    scroller_speed = speed;
+}
+
+// One call covers a whole pass of the text, so the display loop wakes once
+// per item instead of once per frame. Each frame is the tick-rounded
+// vTaskDelay the firmware actually gets for SCROLLER_FRAME_MS.
+int scroller_tick(bool *cycle_complete)
+{
+    int frame_ms = pdTICKS_TO_MS(pdMS_TO_TICKS(SCROLLER_FRAME_MS));
+    if (!cycle_complete) return SCROLLER_FRAME_MS;
+
+    int width = (int)strlen(scroller_text) * SCROLLER_CHAR_PX + sim_scenario.panel_cols;
+    int step = speed_px_per_frame_q8[scroller_speed - 1];
+    int frames = (width * 256 + step - 1) / step;
+    *cycle_complete = strlen(scroller_text) > 0;
+    // The caller converts back with pdMS_TO_TICKS(); keep the result a whole
+    // number of ticks so nothing is lost to rounding.
+    return frames * frame_ms;
+}
+
+// ── LED panel, font, buttons, web server, realtime input ──
+
+esp_err_t led_panel_init(void) { return ESP_OK; }
+void led_panel_clear(void) {}
+void led_panel_set_pixel(int row, int col, uint8_t r, uint8_t g, uint8_t b)
+{
+    (void)row;
+    (void)col;
+    (void)r;
+    (void)g;
+    (void)b;
+}
+esp_err_t led_panel_refresh(void) { return ESP_OK; }
+void led_panel_set_brightness(uint8_t brightness) { (void)brightness; }
+void led_panel_set_cols(uint8_t cols) { (void)cols; }
+uint8_t led_panel_get_cols(void) { return (uint8_t)sim_scenario.panel_cols; }
+void led_panel_get_stats(led_panel_stats_t *out) { memset(out, 0, sizeof(*out)); }
+
+esp_err_t font_init(void) { return ESP_OK; }
+
+esp_err_t gpio_config(const gpio_config_t *conf)
+{
+    (void)conf;
+    return ESP_OK;
+}
+
+esp_err_t gpio_install_isr_service(int flags)
+{
+    (void)flags;
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_add(int gpio_num, void (*handler)(void *), void *arg)
+{
+    (void)gpio_num;
+    (void)handler;
+    (void)arg;
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_init(void) { return ESP_OK; }
+esp_err_t nvs_flash_erase(void) { return ESP_OK; }
+
+void web_server_start(void) {}
+void web_server_stop(void) {}
+
+esp_err_t realtime_ingest_start(void) { return ESP_OK; }
+void realtime_ingest_stop(void) {}
+bool realtime_ingest_active(void) { return false; }
+bool realtime_ingest_wait_frame(const uint8_t **rgb, TickType_t wait)
+{
+    (void)rgb;
+    vTaskDelay(wait);
+    return false;
+}
+
+// ── WiFi ──
+
+static int64_t radio_on_since = -1;
+
+void wifi_manager_init(void) {}
+void wifi_manager_start(void) {}
+
+wifi_mgr_mode_t wifi_manager_get_mode(void)
+{
+    return WIFI_MGR_MODE_STA;
+}
+
+const char *wifi_manager_get_ip(void)
+{
+    return "192.168.4.2";
+}
+
+bool wifi_manager_radio_on(void)
+{
+    sim_stats.radio_ons++;
+    radio_on_since = sim_now_us();
+    if (sim_wifi_outage(sim_now_us())) {
+        sim_sleep_us(WIFI_JOIN_FAIL_MS * 1000LL);
+        sim_stats.radio_failures++;
+        return false;
+    }
+    sim_sleep_us(sim_rand_range(WIFI_JOIN_MIN_MS, WIFI_JOIN_MAX_MS) * 1000);
+    return true;
+}
+
+void wifi_manager_radio_off(void)
+{
+    if (radio_on_since < 0) return;
+    sim_stats.radio_on_us += sim_now_us() - radio_on_since;
+    radio_on_since = -1;
+}
+
+// ── Metrics and trace ──
+
+void metrics_add(metrics_counter_t counter, uint32_t n)
+{
+    if (counter == METRIC_LITTLEFS_WRITE_BYTES) sim_stats.littlefs_app_bytes += n;
+    if (counter == METRIC_NVS_WRITE_BYTES) sim_stats.nvs_bytes += n;
+}
+
+void metrics_observe_fetch(const char *url, uint32_t duration_us, uint32_t bytes, bool ok)
+{
+    int source = -1;
+    for (int i = 0; i < sim_scenario.source_count && source < 0; i++) {
+        char source_url[SETTINGS_MAX_URL_LEN + 1];
+        sim_source_url(i, source_url, sizeof(source_url));
+        if (strcmp(source_url, url) == 0) source = i;
+    }
+    if (source < 0 || source >= SIM_MAX_SOURCES) return;
+    sim_series_add(&sim_stats.fetch_ms[source], duration_us / 1000.0);
+    sim_stats.fetch_bytes[source] += bytes;
+    if (!ok) sim_stats.fetch_failures[source]++;
+}
+
+static int64_t refresh_start_us = -1;
+static int fetch_source_idx = -1;
+
+void trace_begin(trace_cat_t cat, const char *name, int32_t arg)
+{
+    (void)cat;
+    if (strcmp(name, "rss_refresh_cache") == 0) {
+        refresh_start_us = sim_now_us();
+    } else if (strcmp(name, "fetch_source") == 0) {
+        fetch_source_idx = arg;
+    }
+}
+
+void trace_end(trace_cat_t cat, const char *name, int32_t arg)
+{
+    (void)cat;
+    if (strcmp(name, "rss_refresh_cache") == 0 && refresh_start_us >= 0) {
+        sim_series_add(&sim_stats.refresh_ms, (sim_now_us() - refresh_start_us) / 1000.0);
+        refresh_start_us = -1;
+    } else if (strcmp(name, "fetch_source") == 0 && arg == ESP_OK &&
+               fetch_source_idx >= 0 && fetch_source_idx < SIM_MAX_SOURCES) {
+        int count = rss_get_count();
+        sim_stats.cached_items[fetch_source_idx] = (unsigned)(count < RSS_MAX_ITEMS ? count : RSS_MAX_ITEMS);
+    }
+}
+
+void trace_instant(trace_cat_t cat, const char *name, int32_t arg)
+{
+    (void)cat;
+    (void)name;
+    (void)arg;
+}
+
+// ── Logging ──
+
+static esp_log_level_t log_level = ESP_LOG_INFO;
+
+void sim_log(esp_log_level_t level, const char *tag, const char *fmt, ...)
+{
+    if (level == ESP_LOG_ERROR) sim_stats.errors++;
+    if (level == ESP_LOG_WARN) sim_stats.warnings++;
+    if (!sim_scenario.verbose || level > log_level) return;
+
+    static const char letters[] = "NEWIDV";
+    int64_t now = sim_now_us();
+    int64_t s = now / 1000000;
+    printf("[%3d %02d:%02d:%02d.%03d] %c %s: ", (int)(s / 86400), (int)(s / 3600 % 24),
+           (int)(s / 60 % 60), (int)(s % 60), (int)(now / 1000 % 1000), letters[level], tag);
+    va_list args;
+    va_start(args, fmt);
+    vprintf(fmt, args);
+    va_end(args);
+    putchar('\n');
+}
+
+uint32_t esp_log_timestamp(void)
+{
+    return (uint32_t)(sim_now_us() / 1000);
+}
+
+void esp_log_level_set(const char *tag, esp_log_level_t level)
+{
+    if (strcmp(tag, "*") == 0) log_level = level;
+}
+
+// The writer task would only reorder output; log synchronously instead.
+esp_err_t deferred_log_init(void)
+{
+    return ESP_OK;
+}
+
+void deferred_log_write(esp_log_level_t level, const char *tag, const char *fmt,
+                        const char *str, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3)
+{
+    if (level > ESP_LOG_WARN && (!sim_scenario.verbose || level > log_level)) return;
+    char msg[160];
+    if (str) {
+        snprintf(msg, sizeof(msg), fmt, str, a0, a1, a2, a3);
+    } else {
+        snprintf(msg, sizeof(msg), fmt, a0, a1, a2, a3);
+    }
+    sim_log(level, tag, "%s", msg);
+}
+
+esp_err_t deferred_log_set_level(const char *tag, esp_log_level_t level)
+{
+    esp_log_level_set(tag, level);
+    return ESP_OK;
+}
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+    case ESP_OK:                return "ESP_OK";
+    case ESP_FAIL:              return "ESP_FAIL";
+    case ESP_ERR_NO_MEM:        return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG:   return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_INVALID_SIZE:  return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND:     return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_TIMEOUT:       return "ESP_ERR_TIMEOUT";
+    case ESP_ERR_INVALID_CRC:   return "ESP_ERR_INVALID_CRC";
+    case ESP_ERR_HTTP_CONNECT:  return "ESP_ERR_HTTP_CONNECT";
+    default:                    return "UNKNOWN ERROR";
+    }
+}
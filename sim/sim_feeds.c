@@ -0,0 +1,319 @@
+// Feed corpus stand-in and the esp_http_client calls that reach it. Each
+// source publishes new_per_change items every change_min minutes; the
+// document always lists the newest `items`. Headlines carry the source
+// name and a serial number, so the display side can tell which source an
+// item came from and how old it is. Requests cost virtual time (connect,
+// first byte, transfer) and allocate the HTTP and TLS buffers the device
+// would, from the heap model.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "sim_heap.h"
+#include "esp_http_client.h"
+
+#define SIM_FEED_HOST "https://feeds.sim/"
+
+// CONFIG_MBEDTLS_SSL_IN/OUT_CONTENT_LEN, plus the session context.
+#define TLS_IN_BYTES        (16384 + 325)
+#define TLS_OUT_BYTES       (4096 + 325)
+#define TLS_CONTEXT_BYTES   2400
+#define TLS_HANDSHAKE_BYTES 7000   // freed once the handshake is done
+#define HTTP_CLIENT_BYTES   420
+
+#define NET_CONNECT_MIN_MS  400
+#define NET_CONNECT_MAX_MS  1500
+#define NET_TTFB_MIN_MS     80
+#define NET_TTFB_MAX_MS     400
+#define NET_MIN_BPS         30000
+#define NET_MAX_BPS         80000
+#define NET_SEGMENT_BYTES   1436
+
+struct esp_http_client {
+    int source;
+    int timeout_ms;
+    int status;
+    char *body;         // host memory: this is the server's side
+    size_t len;
+    size_t pos;
+    int bytes_per_s;
+    void *client_block;
+    void *rx_buffer;
+    void *tx_buffer;
+    void *tls_in;
+    void *tls_out;
+    void *tls_context;
+};
+
+static const char *const words[] = {
+    "council", "votes", "storm", "season", "record", "market", "rally", "update",
+    "late", "goal", "harbor", "budget", "bridge", "school", "river", "museum",
+    "opens", "closes", "delay", "plan", "team", "coach", "trade", "rain",
+    "crowd", "city", "report", "early", "new", "wins", "loses", "ties",
+};
+#define WORD_COUNT (sizeof(words) / sizeof(words[0]))
+
+void sim_source_url(int i, char *out, size_t size)
+{
+    snprintf(out, size, SIM_FEED_HOST "%d/%s", i, sim_scenario.sources[i].json ? "feed.json" : "feed.xml");
+}
+
+static int64_t change_interval_us(const sim_source_cfg_t *src)
+{
+    return (int64_t)src->change_min * 60 * 1000000;
+}
+
+// Newest serial at time now. Serials 0..items-1 exist from boot.
+static uint32_t newest_serial(const sim_source_cfg_t *src, int64_t now)
+{
+    int64_t version = now / change_interval_us(src);
+    return (uint32_t)(src->items - 1 + version * src->new_per_change);
+}
+
+static uint32_t mix(uint32_t x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+static void append_words(char *out, size_t size, uint32_t seed, int min_len, int max_len)
+{
+    size_t target = (size_t)(min_len + mix(seed) % (uint32_t)(max_len - min_len + 1));
+    size_t len = strlen(out);
+    for (uint32_t i = 1; len < target && len + 10 < size; i++) {
+        const char *w = words[mix(seed + i * 7919u) % WORD_COUNT];
+        len += (size_t)snprintf(out + len, size - len, "%s%s", len ? " " : "", w);
+    }
+}
+
+// JSON sources carry games from 19:00 to 22:00 every day.
+#define GAME_START_H 19
+#define GAME_END_H   22
+
+static bool game_window(int64_t now)
+{
+    int hour = (int)(now / SIM_US_PER_HOUR % 24);
+    return hour >= GAME_START_H && hour < GAME_END_H;
+}
+
+static void item_text(int source, uint32_t serial, char *title, size_t title_size,
+                      char *desc, size_t desc_size)
+{
+    const sim_source_cfg_t *src = &sim_scenario.sources[source];
+    snprintf(title, title_size, "%s #%u:", src->name, (unsigned)serial);
+    append_words(title, title_size, serial * 31u + (uint32_t)source, 30, 90);
+    desc[0] = '\0';
+    if (src->json) {
+        // Score lines: the cache flags these live and the scheduler polls
+        // the source every two minutes while any are.
+        bool live = game_window(sim_now_us());
+        snprintf(desc, desc_size, "%s", live ? "Q3 5:12 in progress" : "Final");
+        return;
+    }
+    append_words(desc, desc_size, serial * 131u + (uint32_t)source + 17u, 60, 190);
+}
+
+bool sim_parse_headline(const char *text, int *source, int64_t *published_us)
+{
+    const char *hash = strstr(text, " #");
+    if (!hash) return false;
+    size_t name_len = (size_t)(hash - text);
+    unsigned serial;
+    if (sscanf(hash + 2, "%u:", &serial) != 1) return false;
+
+    for (int i = 0; i < sim_scenario.source_count; i++) {
+        const sim_source_cfg_t *src = &sim_scenario.sources[i];
+        if (strlen(src->name) != name_len || strncmp(src->name, text, name_len) != 0) continue;
+        int64_t version = serial < (unsigned)src->items
+                              ? 0
+                              : ((int64_t)serial - src->items) / src->new_per_change + 1;
+        *source = i;
+        *published_us = version * change_interval_us(src);
+        return true;
+    }
+    return false;
+}
+
+static char *render_feed(int source, int64_t now, size_t *len_out)
+{
+    const sim_source_cfg_t *src = &sim_scenario.sources[source];
+    size_t cap = 512 + (size_t)src->items * 512;
+    char *body = malloc(cap);
+    size_t len = 0;
+    uint32_t top = newest_serial(src, now);
+
+    if (src->json) {
+        len += (size_t)snprintf(body + len, cap - len, "{\"league\":\"%s\",\"events\":[", src->name);
+    } else {
+        len += (size_t)snprintf(body + len, cap - len,
+                                "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                                "<rss version=\"2.0\"><channel><title>%s</title>\n", src->name);
+    }
+
+    for (int i = 0; i < src->items; i++) {
+        char title[128];
+        char desc[224];
+        uint32_t serial = top - (uint32_t)i;
+        item_text(source, serial, title, sizeof(title), desc, sizeof(desc));
+        if (src->json) {
+            len += (size_t)snprintf(body + len, cap - len,
+                                    "%s{\"id\":%u,\"name\":\"%s\",\"status\":{\"type\":{\"detail\":\"%s\"}}}",
+                                    i ? "," : "", (unsigned)serial, title, desc);
+        } else {
+            len += (size_t)snprintf(body + len, cap - len,
+                                    "<item><title>%s</title><link>" SIM_FEED_HOST "%d/%u</link>"
+                                    "<description>%s</description></item>\n",
+                                    title, source, (unsigned)serial, desc);
+        }
+    }
+
+    len += (size_t)snprintf(body + len, cap - len, "%s", src->json ? "]}" : "</channel></rss>\n");
+    *len_out = len;
+    return body;
+}
+
+static bool source_down(int source, int64_t now)
+{
+    const sim_source_cfg_t *src = &sim_scenario.sources[source];
+    if (src->outage_start_h >= 0) {
+        int64_t start = src->outage_start_h * SIM_US_PER_HOUR;
+        if (now >= start && now < start + src->outage_hours * SIM_US_PER_HOUR) return true;
+    }
+    return (int)(sim_rand() % 100) < src->fail_pct;
+}
+
+bool sim_wifi_outage(int64_t now)
+{
+    if (sim_scenario.wifi_outage_start_h < 0) return false;
+    int64_t start = sim_scenario.wifi_outage_start_h * SIM_US_PER_HOUR;
+    return now >= start && now < start + sim_scenario.wifi_outage_hours * SIM_US_PER_HOUR;
+}
+
+// ── esp_http_client ──
+
+esp_http_client_handle_t esp_http_client_init(const esp_http_client_config_t *config)
+{
+    int source = -1;
+    size_t host_len = strlen(SIM_FEED_HOST);
+    if (config->url && strncmp(config->url, SIM_FEED_HOST, host_len) == 0) {
+        source = atoi(config->url + host_len);
+    }
+    if (source < 0 || source >= sim_scenario.source_count) return NULL;
+
+    struct esp_http_client *c = calloc(1, sizeof(*c));
+    c->source = source;
+    c->timeout_ms = config->timeout_ms;
+    c->client_block = sim_malloc(HTTP_CLIENT_BYTES);
+    c->rx_buffer = sim_malloc((size_t)config->buffer_size);
+    c->tx_buffer = sim_malloc((size_t)config->buffer_size_tx);
+    if (!c->client_block || !c->rx_buffer || !c->tx_buffer) {
+        esp_http_client_cleanup(c);
+        return NULL;
+    }
+    return c;
+}
+
+esp_err_t esp_http_client_set_header(esp_http_client_handle_t client, const char *key,
+                                     const char *value)
+{
+    (void)client;
+    (void)key;
+    (void)value;
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_open(esp_http_client_handle_t c, int write_len)
+{
+    (void)write_len;
+    if (sim_wifi_outage(sim_now_us()) || source_down(c->source, sim_now_us())) {
+        sim_sleep_us((int64_t)c->timeout_ms * 1000);
+        return ESP_ERR_HTTP_CONNECT;
+    }
+
+    c->tls_context = sim_malloc(TLS_CONTEXT_BYTES);
+    c->tls_in = sim_malloc(TLS_IN_BYTES);
+    c->tls_out = sim_malloc(TLS_OUT_BYTES);
+    void *handshake = sim_malloc(TLS_HANDSHAKE_BYTES);
+    sim_sleep_us(sim_rand_range(NET_CONNECT_MIN_MS, NET_CONNECT_MAX_MS) * 1000);
+    sim_free(handshake);
+    if (!c->tls_context || !c->tls_in || !c->tls_out || !handshake) {
+        esp_http_client_close(c);
+        return ESP_ERR_NO_MEM;
+    }
+
+    free(c->body);
+    c->body = render_feed(c->source, sim_now_us(), &c->len);
+    c->pos = 0;
+    c->status = 200;
+    c->bytes_per_s = (int)sim_rand_range(NET_MIN_BPS, NET_MAX_BPS);
+    return ESP_OK;
+}
+
+int64_t esp_http_client_fetch_headers(esp_http_client_handle_t c)
+{
+    if (!c->body) return -1;
+    sim_sleep_us(sim_rand_range(NET_TTFB_MIN_MS, NET_TTFB_MAX_MS) * 1000);
+    return (int64_t)c->len;
+}
+
+int esp_http_client_get_status_code(esp_http_client_handle_t c)
+{
+    return c->status;
+}
+
+esp_err_t esp_http_client_set_redirection(esp_http_client_handle_t c)
+{
+    (void)c;
+    return ESP_OK;
+}
+
+int esp_http_client_read(esp_http_client_handle_t c, char *buf, int len)
+{
+    if (!c->body) return -1;
+    size_t n = c->len - c->pos;
+    if (n > (size_t)len) n = (size_t)len;
+    if (n > NET_SEGMENT_BYTES) n = NET_SEGMENT_BYTES;
+    if (n == 0) return 0;
+
+    sim_sleep_us((int64_t)n * 1000000 / c->bytes_per_s);
+    memcpy(buf, c->body + c->pos, n);
+    c->pos += n;
+    return (int)n;
+}
+
+bool esp_http_client_is_complete_data_received(esp_http_client_handle_t c)
+{
+    return c->body && c->pos >= c->len;
+}
+
+esp_err_t esp_http_client_close(esp_http_client_handle_t c)
+{
+    sim_free(c->tls_in);
+    sim_free(c->tls_out);
+    sim_free(c->tls_context);
+    c->tls_in = c->tls_out = c->tls_context = NULL;
+    free(c->body);
+    c->body = NULL;
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t c)
+{
+    esp_http_client_close(c);
+    sim_free(c->client_block);
+    sim_free(c->rx_buffer);
+    sim_free(c->tx_buffer);
+    free(c);
+    return ESP_OK;
+}
+
+esp_err_t esp_crt_bundle_attach(void *conf)
+{
+    (void)conf;
+    return ESP_OK;
+}
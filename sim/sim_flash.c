@@ -0,0 +1,251 @@
+// The littlefs partition on an emulated NOR flash (lfs_emubd from the
+// bundled littlefs), mounted with the esp_littlefs Kconfig defaults, and
+// the stdio calls the firmware makes on it. emubd counts bytes read,
+// programmed and erased, and erase cycles per block.
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include "sim.h"
+#include "sim_heap.h"
+#include "lfs.h"
+#include "bd/lfs_emubd.h"
+#include "esp_littlefs.h"
+#include "storage_paths.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+// partitions.csv: littlefs, 0x1F0000 bytes.
+#define FLASH_PARTITION_BYTES 0x1F0000
+#define FLASH_BLOCK_BYTES     4096
+
+// Typical SPI NOR timings; flash operations block the calling task.
+#define FLASH_ERASE_US        45000   // one 4 KB sector
+#define FLASH_PROG_US_PER_256 600     // one page
+#define FLASH_ENDURANCE       100000  // erase cycles before a block wears out
+
+typedef struct sim_file {
+    lfs_file_t file;
+} SIM_FILE;
+
+static lfs_t fs;
+static lfs_emubd_t emubd;
+static struct lfs_config cfg;
+static struct lfs_emubd_config emubd_cfg;
+static bool mounted = false;
+static SemaphoreHandle_t fs_lock = NULL;  // esp_littlefs takes a lock per call too
+
+static int bd_prog(const struct lfs_config *c, lfs_block_t block, lfs_off_t off,
+                   const void *buffer, lfs_size_t size)
+{
+    sim_sleep_us((int64_t)(size + 255) / 256 * FLASH_PROG_US_PER_256);
+    return lfs_emubd_prog(c, block, off, buffer, size);
+}
+
+static int bd_erase(const struct lfs_config *c, lfs_block_t block)
+{
+    sim_sleep_us(FLASH_ERASE_US);
+    return lfs_emubd_erase(c, block);
+}
+
+esp_err_t esp_vfs_littlefs_register(const esp_vfs_littlefs_conf_t *conf)
+{
+    if (mounted) return ESP_ERR_INVALID_STATE;
+
+    emubd_cfg = (struct lfs_emubd_config){
+        .read_size = 128,
+        .prog_size = 128,
+        .erase_size = FLASH_BLOCK_BYTES,
+        .erase_count = FLASH_PARTITION_BYTES / FLASH_BLOCK_BYTES,
+        .erase_value = -1,
+        .erase_cycles = FLASH_ENDURANCE,
+        .badblock_behavior = LFS_EMUBD_BADBLOCK_PROGERROR,
+    };
+    // CONFIG_LITTLEFS_* defaults from components/esp_littlefs/Kconfig.
+    cfg = (struct lfs_config){
+        .context = &emubd,
+        .read = lfs_emubd_read,
+        .prog = bd_prog,
+        .erase = bd_erase,
+        .sync = lfs_emubd_sync,
+        .read_size = 128,
+        .prog_size = 128,
+        .block_size = FLASH_BLOCK_BYTES,
+        .block_count = FLASH_PARTITION_BYTES / FLASH_BLOCK_BYTES,
+        .block_cycles = 512,
+        .cache_size = 512,
+        .lookahead_size = 128,
+    };
+    if (lfs_emubd_create(&cfg, &emubd_cfg) != 0) return ESP_FAIL;
+
+    fs_lock = xSemaphoreCreateMutex();
+    int err = lfs_mount(&fs, &cfg);
+    if (err && conf->format_if_mount_failed) {
+        err = lfs_format(&fs, &cfg);
+        if (!err) err = lfs_mount(&fs, &cfg);
+    }
+    if (err) return ESP_FAIL;
+    mounted = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_littlefs_info(const char *partition_label, size_t *total_bytes, size_t *used_bytes)
+{
+    (void)partition_label;
+    if (!mounted) return ESP_ERR_INVALID_STATE;
+    if (total_bytes) *total_bytes = (size_t)cfg.block_size * cfg.block_count;
+    if (used_bytes) *used_bytes = (size_t)cfg.block_size * (size_t)lfs_fs_size(&fs);
+    return ESP_OK;
+}
+
+void sim_flash_get_stats(sim_flash_stats_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    if (!mounted) return;
+    out->read_bytes = (uint64_t)lfs_emubd_readed(&cfg);
+    out->prog_bytes = (uint64_t)lfs_emubd_proged(&cfg);
+    out->erase_bytes = (uint64_t)lfs_emubd_erased(&cfg);
+    out->blocks = cfg.block_count;
+    out->used_blocks = (uint32_t)lfs_fs_size(&fs);
+    for (lfs_block_t b = 0; b < cfg.block_count; b++) {
+        uint32_t wear = (uint32_t)lfs_emubd_wear(&cfg, b);
+        if (wear > out->max_block_erases) out->max_block_erases = wear;
+    }
+}
+
+// ── stdio on littlefs ──
+
+static const char *fs_path(const char *path)
+{
+    size_t base_len = strlen(LITTLEFS_BASE_PATH);
+    if (strncmp(path, LITTLEFS_BASE_PATH, base_len) == 0) path += base_len;
+    return path[0] ? path : "/";
+}
+
+static void set_errno(int lfs_err)
+{
+    switch (lfs_err) {
+    case LFS_ERR_NOENT: errno = ENOENT; break;
+    case LFS_ERR_EXIST: errno = EEXIST; break;
+    case LFS_ERR_NOSPC: errno = ENOSPC; break;
+    case LFS_ERR_NOMEM: errno = ENOMEM; break;
+    default:            errno = EIO; break;
+    }
+}
+
+static int open_flags(const char *mode)
+{
+    bool plus = strchr(mode, '+') != NULL;
+    switch (mode[0]) {
+    case 'r': return plus ? LFS_O_RDWR : LFS_O_RDONLY;
+    case 'w': return (plus ? LFS_O_RDWR : LFS_O_WRONLY) | LFS_O_CREAT | LFS_O_TRUNC;
+    case 'a': return (plus ? LFS_O_RDWR : LFS_O_WRONLY) | LFS_O_CREAT | LFS_O_APPEND;
+    default:  return -1;
+    }
+}
+
+SIM_FILE *sim_fopen(const char *path, const char *mode)
+{
+    int flags = open_flags(mode);
+    if (!mounted || flags < 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+    SIM_FILE *fp = sim_malloc(sizeof(*fp));
+    if (!fp) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    xSemaphoreTake(fs_lock, portMAX_DELAY);
+    int err = lfs_file_open(&fs, &fp->file, fs_path(path), flags);
+    xSemaphoreGive(fs_lock);
+    if (err) {
+        sim_free(fp);
+        set_errno(err);
+        return NULL;
+    }
+    return fp;
+}
+
+size_t sim_fread(void *buf, size_t size, size_t count, SIM_FILE *fp)
+{
+    if (size == 0 || count == 0) return 0;
+    xSemaphoreTake(fs_lock, portMAX_DELAY);
+    lfs_ssize_t n = lfs_file_read(&fs, &fp->file, buf, (lfs_size_t)(size * count));
+    xSemaphoreGive(fs_lock);
+    return n > 0 ? (size_t)n / size : 0;
+}
+
+size_t sim_fwrite(const void *buf, size_t size, size_t count, SIM_FILE *fp)
+{
+    if (size == 0 || count == 0) return 0;
+    xSemaphoreTake(fs_lock, portMAX_DELAY);
+    lfs_ssize_t n = lfs_file_write(&fs, &fp->file, buf, (lfs_size_t)(size * count));
+    xSemaphoreGive(fs_lock);
+    return n > 0 ? (size_t)n / size : 0;
+}
+
+int sim_fseek(SIM_FILE *fp, long offset, int whence)
+{
+    int lfs_whence = whence == SEEK_CUR ? LFS_SEEK_CUR :
+                     whence == SEEK_END ? LFS_SEEK_END : LFS_SEEK_SET;
+    xSemaphoreTake(fs_lock, portMAX_DELAY);
+    lfs_soff_t pos = lfs_file_seek(&fs, &fp->file, (lfs_soff_t)offset, lfs_whence);
+    xSemaphoreGive(fs_lock);
+    if (pos < 0) {
+        set_errno((int)pos);
+        return -1;
+    }
+    return 0;
+}
+
+int sim_fclose(SIM_FILE *fp)
+{
+    xSemaphoreTake(fs_lock, portMAX_DELAY);
+    int err = lfs_file_close(&fs, &fp->file);
+    xSemaphoreGive(fs_lock);
+    sim_free(fp);
+    if (err) {
+        set_errno(err);
+        return EOF;
+    }
+    return 0;
+}
+
+int sim_remove(const char *path)
+{
+    xSemaphoreTake(fs_lock, portMAX_DELAY);
+    int err = lfs_remove(&fs, fs_path(path));
+    xSemaphoreGive(fs_lock);
+    if (err) {
+        set_errno(err);
+        return -1;
+    }
+    return 0;
+}
+
+int sim_rename(const char *from, const char *to)
+{
+    xSemaphoreTake(fs_lock, portMAX_DELAY);
+    int err = lfs_rename(&fs, fs_path(from), fs_path(to));
+    xSemaphoreGive(fs_lock);
+    if (err) {
+        set_errno(err);
+        return -1;
+    }
+    return 0;
+}
+
+int sim_mkdir(const char *path, mode_t mode)
+{
+    (void)mode;
+    xSemaphoreTake(fs_lock, portMAX_DELAY);
+    int err = lfs_mkdir(&fs, fs_path(path));
+    xSemaphoreGive(fs_lock);
+    if (err) {
+        set_errno(err);
+        return -1;
+    }
+    return 0;
+}
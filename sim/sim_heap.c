@@ -0,0 +1,149 @@
+// Heap model: address-ordered first fit over one fixed region, with block
+// splitting and coalescing of free neighbours. It is not the device's
+// allocator, but it fragments the same way under the same sequence of
+// long- and short-lived allocations, which is what the soak run watches.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "sim_heap.h"
+
+#define HEAP_ALIGN      8
+#define HEAP_HDR        8
+#define HEAP_MIN_SPLIT  (HEAP_HDR + 16)
+
+typedef struct {
+    uint32_t size;   // whole block, header included
+    uint32_t used;
+} block_t;
+
+static uint8_t *heap_base = NULL;
+static size_t heap_size = 0;
+static size_t free_bytes = 0;
+static size_t min_free = 0;
+static size_t min_largest = SIZE_MAX;
+static unsigned failures = 0;
+
+static block_t *first_block(void)
+{
+    return (block_t *)heap_base;
+}
+
+static block_t *next_block(block_t *b)
+{
+    uint8_t *n = (uint8_t *)b + b->size;
+    return n < heap_base + heap_size ? (block_t *)n : NULL;
+}
+
+void sim_heap_init(size_t size)
+{
+    size &= ~(size_t)(HEAP_ALIGN - 1);
+    heap_base = malloc(size);
+    if (!heap_base) {
+        fprintf(stderr, "sim: cannot reserve %zu bytes for the heap model\n", size);
+        exit(2);
+    }
+    heap_size = size;
+    block_t *b = first_block();
+    b->size = (uint32_t)size;
+    b->used = 0;
+    free_bytes = size - HEAP_HDR;
+    min_free = free_bytes;
+}
+
+void *sim_malloc(size_t size)
+{
+    if (size == 0) size = 1;
+    size_t need = ((size + HEAP_ALIGN - 1) & ~(size_t)(HEAP_ALIGN - 1)) + HEAP_HDR;
+
+    for (block_t *b = first_block(); b; b = next_block(b)) {
+        if (b->used || b->size < need) continue;
+
+        if (b->size - need >= HEAP_MIN_SPLIT) {
+            block_t *rest = (block_t *)((uint8_t *)b + need);
+            rest->size = b->size - (uint32_t)need;
+            rest->used = 0;
+            b->size = (uint32_t)need;
+            free_bytes -= need;
+        } else {
+            free_bytes -= b->size - HEAP_HDR;
+        }
+        b->used = 1;
+        if (free_bytes < min_free) min_free = free_bytes;
+        return (uint8_t *)b + HEAP_HDR;
+    }
+    failures++;
+    return NULL;
+}
+
+void *sim_calloc(size_t n, size_t size)
+{
+    if (size && n > SIZE_MAX / size) return NULL;
+    void *p = sim_malloc(n * size);
+    if (p) memset(p, 0, n * size);
+    return p;
+}
+
+void sim_free(void *p)
+{
+    if (!p) return;
+    block_t *b = (block_t *)((uint8_t *)p - HEAP_HDR);
+    b->used = 0;
+    free_bytes += b->size - HEAP_HDR;
+
+    block_t *n = next_block(b);
+    if (n && !n->used) {
+        b->size += n->size;
+        free_bytes += HEAP_HDR;
+    }
+
+    block_t *prev = NULL;
+    for (block_t *c = first_block(); c && c != b; c = next_block(c)) prev = c;
+    if (prev && !prev->used) {
+        prev->size += b->size;
+        free_bytes += HEAP_HDR;
+    }
+}
+
+void *sim_realloc(void *p, size_t size)
+{
+    if (!p) return sim_malloc(size);
+    block_t *b = (block_t *)((uint8_t *)p - HEAP_HDR);
+    size_t old = b->size - HEAP_HDR;
+    if (size <= old) return p;
+
+    void *n = sim_malloc(size);
+    if (!n) return NULL;
+    memcpy(n, p, old);
+    sim_free(p);
+    return n;
+}
+
+char *sim_strdup(const char *s)
+{
+    size_t len = strlen(s) + 1;
+    char *p = sim_malloc(len);
+    if (p) memcpy(p, s, len);
+    return p;
+}
+
+void sim_heap_sample(sim_heap_stats_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    for (block_t *b = first_block(); b; b = next_block(b)) {
+        if (b->used) {
+            out->blocks_used++;
+        } else {
+            out->blocks_free++;
+            if (b->size - HEAP_HDR > out->largest_free) out->largest_free = b->size - HEAP_HDR;
+        }
+    }
+    if (out->largest_free < min_largest) min_largest = out->largest_free;
+
+    out->total = heap_size;
+    out->free = free_bytes;
+    out->min_free = min_free;
+    out->min_largest_free = min_largest;
+    out->failures = failures;
+}
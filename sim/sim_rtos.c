@@ -0,0 +1,361 @@
+// FreeRTOS, esp_timer and time() on a virtual clock. Each task is a
+// ucontext coroutine; the scheduler always resumes the task with the
+// earliest wake-up time and jumps the clock to it, so a day of mostly idle
+// firmware runs in milliseconds. Code between blocking calls takes no
+// virtual time; delays come from vTaskDelay() and the network and flash
+// models.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <ucontext.h>
+#include "sim.h"
+#include "sim_heap.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+#include "esp_timer.h"
+#include "esp_random.h"
+
+#define SIM_HOST_STACK_BYTES (256 * 1024)
+#define SIM_TCB_BYTES        352   // TCB allocated next to each task stack
+#define SIM_QUEUE_BYTES      80    // mutex, semaphore or event group object
+#define SIM_TICK_US          (1000000 / configTICK_RATE_HZ)
+
+struct sim_task {
+    ucontext_t ctx;
+    char name[16];
+    TaskFunction_t fn;
+    void *arg;
+    int64_t wake_us;
+    uint64_t order;        // FIFO among tasks waking at the same time
+    uint32_t notify;
+    bool dead;
+    void *host_stack;
+    void *device_block;    // stack + TCB in the heap model
+    struct sim_task *next;
+};
+
+struct sim_sem {
+    int count;
+    int max;
+};
+
+struct sim_event_group {
+    EventBits_t bits;
+};
+
+static struct sim_task *tasks = NULL;
+static struct sim_task *current = NULL;
+static ucontext_t scheduler_ctx;
+static int64_t now_us = 0;
+static uint64_t next_order = 0;
+
+static uint32_t net_rng = 1;
+static uint32_t fw_rng = 1;
+
+static uint32_t xorshift32(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+void sim_seed(uint32_t seed)
+{
+    net_rng = seed ? seed : 1;
+    fw_rng = (seed ^ 0x9e3779b9u) ? (seed ^ 0x9e3779b9u) : 1;
+}
+
+uint32_t sim_rand(void)
+{
+    return xorshift32(&net_rng);
+}
+
+int64_t sim_rand_range(int64_t lo, int64_t hi)
+{
+    if (hi <= lo) return lo;
+    return lo + (int64_t)(sim_rand() % (uint64_t)(hi - lo + 1));
+}
+
+uint32_t esp_random(void)
+{
+    return xorshift32(&fw_rng);
+}
+
+int64_t sim_now_us(void)
+{
+    return now_us;
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return now_us;
+}
+
+time_t sim_time(time_t *out)
+{
+    // No SNTP in the simulation: wall time counts from boot, as on a
+    // device that has not synced yet.
+    time_t t = (time_t)(now_us / 1000000);
+    if (out) *out = t;
+    return t;
+}
+
+// ── Tasks ──
+
+static void yield_to_scheduler(void)
+{
+    struct sim_task *self = current;
+    swapcontext(&self->ctx, &scheduler_ctx);
+}
+
+void sim_sleep_us(int64_t us)
+{
+    if (!current) {
+        now_us += us;  // called outside any task, e.g. during setup
+        return;
+    }
+    current->wake_us = now_us + (us > 0 ? us : 0);
+    current->order = next_order++;
+    yield_to_scheduler();
+}
+
+static void task_entry(void)
+{
+    current->fn(current->arg);
+    // FreeRTOS tasks must not return; treat it as deleting itself.
+    current->dead = true;
+    yield_to_scheduler();
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack_depth,
+                                   void *arg, UBaseType_t prio, TaskHandle_t *out,
+                                   BaseType_t core)
+{
+    (void)prio;
+    (void)core;
+    void *device_block = sim_malloc(stack_depth + SIM_TCB_BYTES);
+    if (!device_block) return pdFAIL;
+
+    struct sim_task *t = calloc(1, sizeof(*t));
+    if (t) t->host_stack = malloc(SIM_HOST_STACK_BYTES);
+    if (!t || !t->host_stack) {
+        fprintf(stderr, "sim: out of host memory\n");
+        exit(2);
+    }
+    snprintf(t->name, sizeof(t->name), "%s", name);
+    t->fn = fn;
+    t->arg = arg;
+    t->device_block = device_block;
+    t->wake_us = now_us;
+    t->order = next_order++;
+
+    getcontext(&t->ctx);
+    t->ctx.uc_stack.ss_sp = t->host_stack;
+    t->ctx.uc_stack.ss_size = SIM_HOST_STACK_BYTES;
+    t->ctx.uc_link = NULL;
+    makecontext(&t->ctx, task_entry, 0);
+
+    t->next = tasks;
+    tasks = t;
+    if (out) *out = t;
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack_depth,
+                       void *arg, UBaseType_t prio, TaskHandle_t *out)
+{
+    return xTaskCreatePinnedToCore(fn, name, stack_depth, arg, prio, out, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    struct sim_task *t = task ? task : current;
+    if (!t) return;
+    t->dead = true;
+    if (t == current) yield_to_scheduler();
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    sim_sleep_us((int64_t)ticks * SIM_TICK_US);
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(now_us / SIM_TICK_US);
+}
+
+TickType_t xTaskGetTickCountFromISR(void)
+{
+    return xTaskGetTickCount();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return current;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    if (task) task->notify++;
+    return pdPASS;
+}
+
+// Blocking waits poll once per tick; nothing in the firmware depends on
+// finer wake-up timing than that.
+static bool wait_tick(TickType_t wait, TickType_t *waited)
+{
+    if (wait != portMAX_DELAY && *waited >= wait) return false;
+    vTaskDelay(1);
+    (*waited)++;
+    return true;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t wait)
+{
+    TickType_t waited = 0;
+    while (current->notify == 0) {
+        if (!wait_tick(wait, &waited)) return 0;
+    }
+    uint32_t value = current->notify;
+    current->notify = clear ? 0 : value - 1;
+    return value;
+}
+
+BaseType_t xPortGetCoreID(void)
+{
+    return 0;
+}
+
+static void reap(struct sim_task *t)
+{
+    for (struct sim_task **p = &tasks; *p; p = &(*p)->next) {
+        if (*p == t) {
+            *p = t->next;
+            break;
+        }
+    }
+    sim_free(t->device_block);
+    free(t->host_stack);
+    free(t);
+}
+
+static struct sim_task *next_runnable(void)
+{
+    struct sim_task *best = NULL;
+    for (struct sim_task *t = tasks; t; t = t->next) {
+        if (t->dead) continue;
+        if (!best || t->wake_us < best->wake_us ||
+            (t->wake_us == best->wake_us && t->order < best->order)) {
+            best = t;
+        }
+    }
+    return best;
+}
+
+void sim_run(int64_t end_us, int64_t tick_period_us, void (*tick)(int64_t now_us))
+{
+    int64_t next_tick = (now_us / tick_period_us + 1) * tick_period_us;
+
+    while (1) {
+        for (struct sim_task *t = tasks, *next; t; t = next) {
+            next = t->next;
+            if (t->dead) reap(t);
+        }
+
+        struct sim_task *t = next_runnable();
+        int64_t when = t ? (t->wake_us > now_us ? t->wake_us : now_us) : end_us + 1;
+        while (next_tick <= when && next_tick <= end_us) {
+            now_us = next_tick;
+            tick(now_us);
+            next_tick += tick_period_us;
+        }
+        if (when > end_us) {
+            now_us = end_us;
+            return;
+        }
+
+        now_us = when;
+        current = t;
+        swapcontext(&scheduler_ctx, &t->ctx);
+        current = NULL;
+    }
+}
+
+// ── Semaphores and event groups ──
+
+static struct sim_sem *sem_create(int count, int max)
+{
+    struct sim_sem *s = sim_malloc(SIM_QUEUE_BYTES);
+    if (!s) return NULL;
+    s->count = count;
+    s->max = max;
+    return s;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return sem_create(1, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return sem_create(0, 1);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t wait)
+{
+    TickType_t waited = 0;
+    while (sem->count == 0) {
+        if (!current || !wait_tick(wait, &waited)) return pdFALSE;
+    }
+    sem->count--;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    if (sem->count >= sem->max) return pdFALSE;
+    sem->count++;
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem)
+{
+    sim_free(sem);
+}
+
+EventGroupHandle_t xEventGroupCreate(void)
+{
+    struct sim_event_group *g = sim_malloc(SIM_QUEUE_BYTES);
+    if (g) g->bits = 0;
+    return g;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits,
+                                BaseType_t clear_on_exit, BaseType_t wait_for_all,
+                                TickType_t wait)
+{
+    TickType_t waited = 0;
+    while (1) {
+        EventBits_t set = group->bits & bits;
+        if (wait_for_all ? set == bits : set != 0) break;
+        if (!current || !wait_tick(wait, &waited)) return group->bits;
+    }
+    EventBits_t value = group->bits;
+    if (clear_on_exit) group->bits &= ~bits;
+    return value;
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits)
+{
+    group->bits |= bits;
+    return group->bits;
+}
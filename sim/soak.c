@@ -0,0 +1,288 @@
+// Soak run: boots the firmware's display loop, feed scheduler, fetcher and
+// cache against the scenario below, runs weeks of virtual time, and reports
+// heap, flash wear, rotation fairness and refresh timing.
+//
+//   make -C sim && sim/build/soak --days 28
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include "sim.h"
+#include "sim_heap.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// CONFIG_ESP_MAIN_TASK_STACK_SIZE in sdkconfig.
+#define MAIN_TASK_STACK 3584
+
+// Heap left to the application once WiFi, lwIP and the other system
+// components are up; roughly what esp_get_free_heap_size() reports on a
+// connected ESP32 before the first fetch.
+#define DEFAULT_HEAP_KB 160
+
+void app_main(void);
+
+sim_scenario_t sim_scenario = {
+    .days = 14,
+    .seed = 1,
+    .heap_bytes = DEFAULT_HEAP_KB * 1024,
+    .background_refresh = true,
+    .refresh_budget_s = 30,
+    .speed = 5,
+    .panel_cols = 64,
+    .wifi_outage_start_h = 100,
+    .wifi_outage_hours = 3,
+    .source_count = 5,
+    .sources = {
+        {"News",   false, 20, 30,  2, 2,  -1, 0},
+        {"Sports", false, 25, 5,   1, 2,  -1, 0},
+        {"Tech",   false, 15, 120, 3, 2,  -1, 0},
+        {"Scores", true,  12, 10,  2, 2,  -1, 0},
+        {"Flaky",  false, 10, 60,  1, 20, 60, 10},
+    },
+};
+
+sim_stats_t sim_stats;
+
+void sim_series_add(sim_series_t *s, double value)
+{
+    if (s->len == s->cap) {
+        s->cap = s->cap ? s->cap * 2 : 64;
+        s->v = realloc(s->v, s->cap * sizeof(*s->v));
+    }
+    s->v[s->len++] = value;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Sorts the series in place; call once reporting starts.
+static double percentile(sim_series_t *s, double p)
+{
+    if (s->len == 0) return 0;
+    qsort(s->v, s->len, sizeof(*s->v), cmp_double);
+    size_t i = (size_t)(p / 100.0 * (double)(s->len - 1) + 0.5);
+    return s->v[i];
+}
+
+static size_t count_below(const sim_series_t *s, double limit)
+{
+    size_t n = 0;
+    for (size_t i = 0; i < s->len; i++) {
+        if (s->v[i] < limit) n++;
+    }
+    return n;
+}
+
+// ── Daily progress ──
+
+static unsigned day_headlines = 0;
+static size_t day_refreshes = 0;
+
+static void print_day_header(void)
+{
+    printf("%4s %9s %9s %9s %9s %6s %10s %10s %7s\n", "day", "headlines", "refreshes",
+           "heap free", "largest", "frag", "prog KB", "erase KB", "blocks");
+}
+
+static void daily_tick(int64_t now)
+{
+    sim_heap_stats_t heap;
+    sim_flash_stats_t flash;
+    sim_heap_sample(&heap);
+    sim_flash_get_stats(&flash);
+
+    double frag = heap.free ? 100.0 * (1.0 - (double)heap.largest_free / heap.free) : 0;
+    printf("%4d %9u %9zu %9zu %9zu %5.1f%% %10llu %10llu %3u/%-3u\n",
+           (int)(now / SIM_US_PER_DAY), sim_stats.headlines - day_headlines,
+           sim_stats.refresh_ms.len - day_refreshes, heap.free, heap.largest_free, frag,
+           (unsigned long long)(flash.prog_bytes / 1024),
+           (unsigned long long)(flash.erase_bytes / 1024), flash.used_blocks, flash.blocks);
+    fflush(stdout);
+    day_headlines = sim_stats.headlines;
+    day_refreshes = sim_stats.refresh_ms.len;
+}
+
+// ── Report ──
+
+static void report_heap(const sim_heap_stats_t *heap)
+{
+    printf("\nHeap (%zu KB model)\n", heap->total / 1024);
+    printf("  free now        %zu bytes in %zu free blocks (%zu in use)\n",
+           heap->free, heap->blocks_free, heap->blocks_used);
+    printf("  low-water       %zu bytes free\n", heap->min_free);
+    printf("  largest block   %zu now, %zu lowest seen at a daily sample\n",
+           heap->largest_free, heap->min_largest_free);
+    printf("  failed allocs   %u\n", heap->failures);
+}
+
+static void report_flash(const sim_flash_stats_t *flash)
+{
+    double days = sim_scenario.days;
+    double app = (double)sim_stats.littlefs_app_bytes;
+    printf("\nFlash (littlefs, %u x 4 KB blocks)\n", flash->blocks);
+    printf("  cache writes    %.1f KB by the firmware (%.1f KB/day)\n", app / 1024, app / 1024 / days);
+    printf("  programmed      %.1f KB (%.2fx write amplification)\n",
+           flash->prog_bytes / 1024.0, app > 0 ? flash->prog_bytes / app : 0);
+    printf("  erased          %.1f KB (%.1f KB/day)\n",
+           flash->erase_bytes / 1024.0, flash->erase_bytes / 1024.0 / days);
+    printf("  most-worn block %u erases", flash->max_block_erases);
+    if (flash->max_block_erases > 0) {
+        double years = 100000.0 / (flash->max_block_erases / days) / 365.0;
+        printf(" (100k cycles reached in %.1f years at this rate)", years);
+    }
+    printf("\n  blocks in use   %u\n", flash->used_blocks);
+    if (sim_stats.nvs_bytes) {
+        printf("  NVS writes      %llu bytes\n", (unsigned long long)sim_stats.nvs_bytes);
+    }
+}
+
+static void report_rotation(void)
+{
+    printf("\nRotation (%u headlines shown)\n", sim_stats.headlines);
+    printf("  %-8s %7s %7s %8s %8s %6s\n", "source", "cached", "shows", "share", "expected", "ratio");
+    for (int i = 0; i < sim_scenario.source_count; i++) {
+        double share = sim_stats.headlines ? 100.0 * sim_stats.source_shows[i] / sim_stats.headlines : 0;
+        double expected = sim_stats.headlines ? 100.0 * sim_stats.expected_share[i] / sim_stats.headlines : 0;
+        printf("  %-8s %7u %7u %7.1f%% %7.1f%% %6.2f\n", sim_scenario.sources[i].name,
+               sim_stats.cached_items[i], sim_stats.source_shows[i], share, expected,
+               expected > 0 ? share / expected : 0);
+    }
+
+    sim_series_t *gap = &sim_stats.repeat_gap;
+    size_t early = count_below(gap, 0.5);
+    printf("  repeats         %zu; gap in pool sizes p10 %.2f, median %.2f; "
+           "%zu (%.1f%%) came back within half a pool\n",
+           gap->len, percentile(gap, 10), percentile(gap, 50), early,
+           gap->len ? 100.0 * early / gap->len : 0);
+
+    sim_series_t *age = &sim_stats.age_s;
+    printf("  headline age    median %.0f min, p90 %.0f min, max %.0f min\n",
+           percentile(age, 50) / 60, percentile(age, 90) / 60, percentile(age, 100) / 60);
+}
+
+static void report_refresh(void)
+{
+    sim_series_t *r = &sim_stats.refresh_ms;
+    printf("\nRefresh (%zu windows, budget %d s, %s)\n", r->len, sim_scenario.refresh_budget_s,
+           sim_scenario.background_refresh ? "background" : "foreground");
+    printf("  duration        median %.0f ms, p90 %.0f ms, max %.0f ms\n",
+           percentile(r, 50), percentile(r, 90), percentile(r, 100));
+    printf("  radio           %u joins, %u failed, on %.2f%% of the time\n",
+           sim_stats.radio_ons, sim_stats.radio_failures,
+           100.0 * (double)sim_stats.radio_on_us / ((double)sim_scenario.days * SIM_US_PER_DAY));
+
+    printf("  %-8s %7s %7s %10s %10s %10s\n", "source", "fetches", "failed", "median ms", "p90 ms", "avg bytes");
+    for (int i = 0; i < sim_scenario.source_count; i++) {
+        sim_series_t *f = &sim_stats.fetch_ms[i];
+        printf("  %-8s %7zu %7u %10.0f %10.0f %10.0f\n", sim_scenario.sources[i].name, f->len,
+               sim_stats.fetch_failures[i], percentile(f, 50), percentile(f, 90),
+               f->len ? (double)sim_stats.fetch_bytes[i] / f->len : 0);
+    }
+    printf("\nLog: %u errors, %u warnings\n", sim_stats.errors, sim_stats.warnings);
+}
+
+// ── Main ──
+
+static void main_task(void *arg)
+{
+    (void)arg;
+    app_main();
+    // app_main only returns on a fatal init error; on the device the task
+    // would then be deleted and the idle task would keep running.
+}
+
+static void usage(const char *prog)
+{
+    printf("usage: %s [options]\n"
+           "  --days N        virtual days to run (default %d)\n"
+           "  --seed N        network and firmware PRNG seed (default %u)\n"
+           "  --heap-kb N     heap available to the application (default %d)\n"
+           "  --budget S      rss_refresh_budget_s (default %d)\n"
+           "  --foreground    refresh in the display loop instead of in the background\n"
+           "  --speed N       scroll speed 1-10 (default %d)\n"
+           "  --cols N        panel width in columns (default %d)\n"
+           "  --no-outages    drop the scripted WiFi and source outages\n"
+           "  --verbose       print the firmware log with virtual timestamps\n",
+           prog, sim_scenario.days, (unsigned)sim_scenario.seed, DEFAULT_HEAP_KB,
+           sim_scenario.refresh_budget_s, sim_scenario.speed, sim_scenario.panel_cols);
+}
+
+int main(int argc, char **argv)
+{
+    static const struct option options[] = {
+        {"days", required_argument, NULL, 'd'},
+        {"seed", required_argument, NULL, 's'},
+        {"heap-kb", required_argument, NULL, 'h'},
+        {"budget", required_argument, NULL, 'b'},
+        {"foreground", no_argument, NULL, 'f'},
+        {"speed", required_argument, NULL, 'v'},
+        {"cols", required_argument, NULL, 'c'},
+        {"no-outages", no_argument, NULL, 'n'},
+        {"verbose", no_argument, NULL, 'V'},
+        {"help", no_argument, NULL, '?'},
+        {NULL, 0, NULL, 0},
+    };
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "", options, NULL)) != -1) {
+        switch (opt) {
+        case 'd': sim_scenario.days = atoi(optarg); break;
+        case 's': sim_scenario.seed = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'h': sim_scenario.heap_bytes = (size_t)atoi(optarg) * 1024; break;
+        case 'b': sim_scenario.refresh_budget_s = atoi(optarg); break;
+        case 'f': sim_scenario.background_refresh = false; break;
+        case 'v': sim_scenario.speed = atoi(optarg); break;
+        case 'c': sim_scenario.panel_cols = atoi(optarg); break;
+        case 'n':
+            sim_scenario.wifi_outage_start_h = -1;
+            for (int i = 0; i < sim_scenario.source_count; i++) {
+                sim_scenario.sources[i].outage_start_h = -1;
+            }
+            break;
+        case 'V': sim_scenario.verbose = true; break;
+        default:
+            usage(argv[0]);
+            return opt == '?' ? 0 : 2;
+        }
+    }
+    if (sim_scenario.days < 1 || sim_scenario.heap_bytes < 16 * 1024 ||
+        sim_scenario.speed < 1 || sim_scenario.speed > 10 ||
+        sim_scenario.panel_cols < 8 || sim_scenario.panel_cols > 128 ||
+        sim_scenario.refresh_budget_s < 10 || sim_scenario.refresh_budget_s > 120) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    sim_seed(sim_scenario.seed);
+    sim_heap_init(sim_scenario.heap_bytes);
+
+    printf("Soak: %d days, seed %u, %zu KB heap, %d sources, %s refresh, %d s budget\n",
+           sim_scenario.days, (unsigned)sim_scenario.seed, sim_scenario.heap_bytes / 1024,
+           sim_scenario.source_count, sim_scenario.background_refresh ? "background" : "foreground",
+           sim_scenario.refresh_budget_s);
+    print_day_header();
+
+    xTaskCreate(main_task, "main", MAIN_TASK_STACK, NULL, 1, NULL);
+    sim_run((int64_t)sim_scenario.days * SIM_US_PER_DAY, SIM_US_PER_DAY, daily_tick);
+
+    sim_heap_stats_t heap;
+    sim_flash_stats_t flash;
+    sim_heap_sample(&heap);
+    sim_flash_get_stats(&flash);
+    report_heap(&heap);
+    report_flash(&flash);
+    report_rotation();
+    report_refresh();
+
+    if (heap.failures > 0 || sim_stats.headlines == 0) {
+        printf("\nFAIL: %s\n", heap.failures ? "allocations failed" : "no headlines were shown");
+        return 1;
+    }
+    return 0;
+}
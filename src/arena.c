@@ -0,0 +1,36 @@
+#include "arena.h"
+#include <string.h>
+
+void arena_init(arena_t *a, void *buf, size_t size)
+{
+    // Trim the start so every allocation is aligned.
+    uintptr_t start = ((uintptr_t)buf + ARENA_ALIGN - 1) & ~(uintptr_t)(ARENA_ALIGN - 1);
+    size_t skip = start - (uintptr_t)buf;
+    a->base = (uint8_t *)start;
+    a->size = size > skip ? size - skip : 0;
+    a->used = 0;
+    a->peak = 0;
+}
+
+void *arena_alloc(arena_t *a, size_t size)
+{
+    size_t rounded = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    if (rounded < size || rounded > a->size - a->used) return NULL;
+
+    void *p = a->base + a->used;
+    a->used += rounded;
+    if (a->used > a->peak) a->peak = a->used;
+    return p;
+}
+
+void *arena_calloc(arena_t *a, size_t size)
+{
+    void *p = arena_alloc(a, size);
+    if (p) memset(p, 0, size);
+    return p;
+}
+
+void arena_reset(arena_t *a)
+{
+    a->used = 0;
+}
@@ -0,0 +1,57 @@
+#include "boot_profile.h"
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+static const char *TAG = "boot";
+
+static const char *const stage_names[BOOT_STAGE_COUNT] = {
+    [BOOT_STAGE_NVS] = "nvs",
+    [BOOT_STAGE_LITTLEFS] = "littlefs",
+    [BOOT_STAGE_SETTINGS] = "settings",
+    [BOOT_STAGE_LED_PANEL] = "led_panel",
+    [BOOT_STAGE_FONT] = "font",
+    [BOOT_STAGE_DISPLAY] = "display",
+    [BOOT_STAGE_WIFI_INIT] = "wifi_init",
+    [BOOT_STAGE_NETWORK] = "network",
+    [BOOT_STAGE_FIRST_HEADLINE] = "first_headline",
+};
+
+// Stages are marked from app_main and the network start task concurrently.
+static int64_t stage_us[BOOT_STAGE_COUNT];
+static portMUX_TYPE boot_mux = portMUX_INITIALIZER_UNLOCKED;
+
+void boot_profile_mark(boot_stage_t stage)
+{
+    if (stage < 0 || stage >= BOOT_STAGE_COUNT) return;
+
+    int64_t now = esp_timer_get_time();
+    bool first = false;
+    portENTER_CRITICAL(&boot_mux);
+    if (stage_us[stage] == 0) {
+        stage_us[stage] = now;
+        first = true;
+    }
+    portEXIT_CRITICAL(&boot_mux);
+
+    if (first) {
+        ESP_LOGI(TAG, "%s at %lld ms", stage_names[stage], (long long)(now / 1000));
+    }
+}
+
+int32_t boot_profile_get_ms(boot_stage_t stage)
+{
+    if (stage < 0 || stage >= BOOT_STAGE_COUNT) return -1;
+
+    portENTER_CRITICAL(&boot_mux);
+    int64_t us = stage_us[stage];
+    portEXIT_CRITICAL(&boot_mux);
+    return us ? (int32_t)(us / 1000) : -1;
+}
+
+const char *boot_profile_stage_name(boot_stage_t stage)
+{
+    if (stage < 0 || stage >= BOOT_STAGE_COUNT) return "unknown";
+    return stage_names[stage];
+}
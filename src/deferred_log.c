@@ -0,0 +1,225 @@
+#include "deferred_log.h"
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = "dlog";
+
+#define DLOG_TAG_LEN   16
+#define DLOG_MSG_LEN   160
+
+typedef struct {
+    atomic_uint seq;     // index + 1 once the slot is written; 0 while writing
+    uint32_t ts_ms;
+    const char *tag;
+    const char *fmt;
+    uint32_t args[4];
+    uint8_t level;
+    bool has_str;
+    char str[DEFERRED_LOG_STR_LEN];
+} dlog_entry_t;
+
+typedef struct {
+    char name[DLOG_TAG_LEN];
+    atomic_int level;
+} dlog_tag_level_t;
+
+static dlog_entry_t ring[DEFERRED_LOG_RING_SIZE];
+static atomic_uint head;
+static uint32_t tail;                   // writer task only
+static atomic_uint dropped;
+
+static dlog_tag_level_t tag_levels[DEFERRED_LOG_MAX_TAGS];
+static atomic_int tag_count;
+static atomic_int default_level = CONFIG_LOG_DEFAULT_LEVEL;
+static SemaphoreHandle_t levels_mutex = NULL;   // serializes set_level only
+
+static TaskHandle_t writer_task = NULL;
+
+// Readers never lock: names are written before tag_count publishes them and
+// never change afterwards.
+static esp_log_level_t level_for(const char *tag)
+{
+    int count = atomic_load_explicit(&tag_count, memory_order_acquire);
+    for (int i = 0; i < count; i++) {
+        if (strcmp(tag_levels[i].name, tag) == 0) {
+            return atomic_load_explicit(&tag_levels[i].level, memory_order_relaxed);
+        }
+    }
+    return atomic_load_explicit(&default_level, memory_order_relaxed);
+}
+
+void deferred_log_write(esp_log_level_t level, const char *tag, const char *fmt,
+                        const char *str, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3)
+{
+    if (level == ESP_LOG_NONE || level > level_for(tag)) return;
+
+    uint32_t index = atomic_fetch_add_explicit(&head, 1, memory_order_relaxed);
+    dlog_entry_t *e = &ring[index & (DEFERRED_LOG_RING_SIZE - 1)];
+    atomic_store_explicit(&e->seq, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    e->ts_ms = esp_log_timestamp();
+    e->tag = tag;
+    e->fmt = fmt;
+    e->args[0] = a0;
+    e->args[1] = a1;
+    e->args[2] = a2;
+    e->args[3] = a3;
+    e->level = (uint8_t)level;
+    e->has_str = str != NULL;
+    if (str) {
+        strncpy(e->str, str, sizeof(e->str) - 1);
+        e->str[sizeof(e->str) - 1] = '\0';
+    }
+    atomic_store_explicit(&e->seq, index + 1, memory_order_release);
+
+    if (writer_task) xTaskNotifyGive(writer_task);
+}
+
+// Copy slot index out of the ring. False if it was overwritten (or is
+// being written) while we looked.
+static bool read_entry(uint32_t index, dlog_entry_t *out)
+{
+    const dlog_entry_t *e = &ring[index & (DEFERRED_LOG_RING_SIZE - 1)];
+    if (atomic_load_explicit(&e->seq, memory_order_acquire) != index + 1) return false;
+    out->ts_ms = e->ts_ms;
+    out->tag = e->tag;
+    out->fmt = e->fmt;
+    memcpy(out->args, e->args, sizeof(out->args));
+    out->level = e->level;
+    out->has_str = e->has_str;
+    if (e->has_str) memcpy(out->str, e->str, sizeof(out->str));
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&e->seq, memory_order_relaxed) == index + 1;
+}
+
+static char level_letter(esp_log_level_t level)
+{
+    switch (level) {
+    case ESP_LOG_ERROR: return 'E';
+    case ESP_LOG_WARN:  return 'W';
+    case ESP_LOG_INFO:  return 'I';
+    case ESP_LOG_DEBUG: return 'D';
+    default:            return 'V';
+    }
+}
+
+static void emit(const dlog_entry_t *e)
+{
+    char msg[DLOG_MSG_LEN];
+    if (e->has_str) {
+        snprintf(msg, sizeof(msg), e->fmt, e->str,
+                 e->args[0], e->args[1], e->args[2], e->args[3]);
+    } else {
+        snprintf(msg, sizeof(msg), e->fmt,
+                 e->args[0], e->args[1], e->args[2], e->args[3]);
+    }
+    // Same layout as ESP_LOGx, stamped with the time the entry was recorded.
+    esp_log_write((esp_log_level_t)e->level, e->tag, "%c (%u) %s: %s\n",
+                  level_letter(e->level), (unsigned)e->ts_ms, e->tag, msg);
+}
+
+static void drain(void)
+{
+    uint32_t lost = 0;
+    uint32_t h = atomic_load_explicit(&head, memory_order_acquire);
+    if (h - tail > DEFERRED_LOG_RING_SIZE) {
+        lost += h - tail - DEFERRED_LOG_RING_SIZE;
+        tail = h - DEFERRED_LOG_RING_SIZE;
+    }
+
+    while (tail != h) {
+        dlog_entry_t e;
+        if (read_entry(tail, &e)) {
+            emit(&e);
+        } else {
+            uint32_t seq = atomic_load_explicit(
+                &ring[tail & (DEFERRED_LOG_RING_SIZE - 1)].seq, memory_order_acquire);
+            // Still being written: its producer notifies us when done.
+            if (seq == 0 || seq == tail + 1) break;
+            lost++;   // lapped by newer entries
+        }
+        tail++;
+    }
+
+    if (lost) {
+        atomic_fetch_add_explicit(&dropped, lost, memory_order_relaxed);
+        esp_log_write(ESP_LOG_WARN, TAG, "W (%u) %s: %u entries dropped\n",
+                      (unsigned)esp_log_timestamp(), TAG, (unsigned)lost);
+    }
+}
+
+static void writer_task_fn(void *arg)
+{
+    (void)arg;
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        drain();
+    }
+}
+
+esp_err_t deferred_log_init(void)
+{
+    if (writer_task) return ESP_OK;
+
+    levels_mutex = xSemaphoreCreateMutex();
+    if (!levels_mutex) return ESP_ERR_NO_MEM;
+
+    // Lowest useful priority: lines go out whenever both cores are idle.
+    if (xTaskCreate(writer_task_fn, "deferred_log", 3072, NULL, 1, &writer_task) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to start writer task");
+        return ESP_ERR_NO_MEM;
+    }
+    xTaskNotifyGive(writer_task);   // flush entries recorded during boot
+    return ESP_OK;
+}
+
+esp_err_t deferred_log_set_level(const char *tag, esp_log_level_t level)
+{
+    if (!tag || !tag[0] || level > ESP_LOG_VERBOSE) return ESP_ERR_INVALID_ARG;
+    if (!levels_mutex) return ESP_ERR_INVALID_STATE;
+
+    esp_err_t err = ESP_OK;
+    xSemaphoreTake(levels_mutex, portMAX_DELAY);
+    if (strcmp(tag, "*") == 0) {
+        atomic_store_explicit(&default_level, level, memory_order_relaxed);
+    } else {
+        int count = atomic_load_explicit(&tag_count, memory_order_relaxed);
+        int i = 0;
+        while (i < count && strcmp(tag_levels[i].name, tag) != 0) i++;
+        if (i < count) {
+            atomic_store_explicit(&tag_levels[i].level, level, memory_order_relaxed);
+        } else if (count < DEFERRED_LOG_MAX_TAGS && strlen(tag) < DLOG_TAG_LEN) {
+            strcpy(tag_levels[count].name, tag);
+            atomic_store_explicit(&tag_levels[count].level, level, memory_order_relaxed);
+            atomic_store_explicit(&tag_count, count + 1, memory_order_release);
+        } else {
+            err = ESP_ERR_NO_MEM;
+        }
+    }
+    xSemaphoreGive(levels_mutex);
+
+    if (err == ESP_OK) esp_log_level_set(tag, level);
+    return err;
+}
+
+bool deferred_log_parse_level(const char *name, esp_log_level_t *out)
+{
+    static const char *const names[] = {"none", "error", "warn", "info", "debug", "verbose"};
+    for (int i = 0; i < (int)(sizeof(names) / sizeof(names[0])); i++) {
+        if (strcasecmp(name, names[i]) == 0) {
+            *out = (esp_log_level_t)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t deferred_log_dropped(void)
+{
+    return atomic_load_explicit(&dropped, memory_order_relaxed);
+}
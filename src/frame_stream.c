@@ -0,0 +1,278 @@
+#include "frame_stream.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+
+static const char *TAG = "frame_stream";
+
+#define FRAME_STREAM_TASK_CORE 0
+#define FRAME_WAIT_MS          250   // display idle (e.g. config mode redraws)
+#define IDLE_POLL_MS           200   // no clients connected
+
+typedef struct {
+    httpd_handle_t server;
+    int fd;                 // -1 when the slot is free
+    TickType_t period;
+    TickType_t next_due;
+    bool need_keyframe;
+} client_t;
+
+static client_t clients[FRAME_STREAM_MAX_CLIENTS];
+static SemaphoreHandle_t clients_mutex = NULL;
+static TaskHandle_t stream_task = NULL;
+
+// Owned by the stream task: the sampled frame, what each client last
+// received, and the encode buffer.
+static led_panel_frame_t current;
+static led_panel_frame_t last_sent[FRAME_STREAM_MAX_CLIENTS];
+static uint8_t msg_buf[FRAME_STREAM_MAX_MSG];
+
+static bool column_equal(const led_panel_frame_t *a, int ca, const led_panel_frame_t *b, int cb)
+{
+    for (int row = 0; row < PANEL_ROWS; row++) {
+        const pixel_rgb_t *p = &a->px[row][ca];
+        const pixel_rgb_t *q = &b->px[row][cb];
+        if (p->r != q->r || p->g != q->g || p->b != q->b) return false;
+    }
+    return true;
+}
+
+static bool column_blank(const led_panel_frame_t *f, int col)
+{
+    for (int row = 0; row < PANEL_ROWS; row++) {
+        const pixel_rgb_t *p = &f->px[row][col];
+        if (p->r || p->g || p->b) return false;
+    }
+    return true;
+}
+
+// Does cur column col match prev scrolled left by shift?
+static bool column_matches_shifted(const led_panel_frame_t *prev, const led_panel_frame_t *cur,
+                                   int col, int shift)
+{
+    int src = col + shift;
+    if (src < prev->cols) return column_equal(cur, col, prev, src);
+    return column_blank(cur, col);
+}
+
+static uint8_t *put_column(uint8_t *p, const led_panel_frame_t *f, int col)
+{
+    for (int row = 0; row < PANEL_ROWS; row++) {
+        *p++ = f->px[row][col].r;
+        *p++ = f->px[row][col].g;
+        *p++ = f->px[row][col].b;
+    }
+    return p;
+}
+
+static size_t encode_keyframe(const led_panel_frame_t *cur, uint8_t *out)
+{
+    uint8_t *p = out;
+    *p++ = FRAME_STREAM_KEYFRAME;
+    *p++ = cur->cols;
+    *p++ = PANEL_ROWS;
+    for (int col = 0; col < cur->cols; col++) {
+        p = put_column(p, cur, col);
+    }
+    return p - out;
+}
+
+size_t frame_stream_encode(const led_panel_frame_t *prev, const led_panel_frame_t *cur,
+                           uint8_t *out)
+{
+    int cols = cur->cols;
+    if (!prev || prev->cols != cols) return encode_keyframe(cur, out);
+
+    // Scrolling text moves the whole frame left by a few columns per tick;
+    // find the shift that leaves the fewest columns to send.
+    int best_shift = 0;
+    int best_changed = cols + 1;
+    int max_shift = cols - 1 < FRAME_STREAM_MAX_SHIFT ? cols - 1 : FRAME_STREAM_MAX_SHIFT;
+    for (int shift = 0; shift <= max_shift; shift++) {
+        int changed = 0;
+        for (int col = 0; col < cols && changed < best_changed; col++) {
+            if (!column_matches_shifted(prev, cur, col, shift)) changed++;
+        }
+        if (changed < best_changed) {
+            best_changed = changed;
+            best_shift = shift;
+        }
+        if (changed == 0) break;
+    }
+
+    if (best_changed == 0 && best_shift == 0) return 0;
+
+    size_t column_bytes = 1 + PANEL_ROWS * 3;
+    if (3 + best_changed * column_bytes >= 3 + cols * (PANEL_ROWS * 3)) {
+        return encode_keyframe(cur, out);
+    }
+
+    uint8_t *p = out;
+    *p++ = FRAME_STREAM_DELTA;
+    *p++ = best_shift;
+    *p++ = best_changed;
+    for (int col = 0; col < cols; col++) {
+        if (column_matches_shifted(prev, cur, col, best_shift)) continue;
+        *p++ = col;
+        p = put_column(p, cur, col);
+    }
+    return p - out;
+}
+
+static void drop_client(int slot, int fd)
+{
+    xSemaphoreTake(clients_mutex, portMAX_DELAY);
+    if (clients[slot].fd == fd) {
+        clients[slot].fd = -1;
+        ESP_LOGI(TAG, "Client fd %d removed", fd);
+    }
+    xSemaphoreGive(clients_mutex);
+}
+
+// Shortest period among connected clients, or 0 if there are none.
+static TickType_t min_period(void)
+{
+    TickType_t period = 0;
+    xSemaphoreTake(clients_mutex, portMAX_DELAY);
+    for (int i = 0; i < FRAME_STREAM_MAX_CLIENTS; i++) {
+        if (clients[i].fd < 0) continue;
+        if (period == 0 || clients[i].period < period) period = clients[i].period;
+    }
+    xSemaphoreGive(clients_mutex);
+    return period;
+}
+
+static void send_to_client(int slot)
+{
+    xSemaphoreTake(clients_mutex, portMAX_DELAY);
+    client_t c = clients[slot];
+    TickType_t now = xTaskGetTickCount();
+    bool due = c.fd >= 0 && (int32_t)(now - c.next_due) >= 0;
+    if (due) {
+        clients[slot].need_keyframe = false;
+        clients[slot].next_due = now + c.period;
+    }
+    xSemaphoreGive(clients_mutex);
+    if (!due) return;
+
+    if (httpd_ws_get_fd_info(c.server, c.fd) != HTTPD_WS_CLIENT_WEBSOCKET) {
+        drop_client(slot, c.fd);
+        return;
+    }
+
+    size_t len = frame_stream_encode(c.need_keyframe ? NULL : &last_sent[slot], &current, msg_buf);
+    if (len == 0) return;
+
+    httpd_ws_frame_t frame = {
+        .final = true,
+        .fragmented = false,
+        .type = HTTPD_WS_TYPE_BINARY,
+        .payload = msg_buf,
+        .len = len,
+    };
+    if (httpd_ws_send_frame_async(c.server, c.fd, &frame) != ESP_OK) {
+        drop_client(slot, c.fd);
+        return;
+    }
+    last_sent[slot] = current;
+}
+
+static void frame_stream_task(void *arg)
+{
+    (void)arg;
+    while (1) {
+        TickType_t period = min_period();
+        if (period == 0) {
+            vTaskDelay(pdMS_TO_TICKS(IDLE_POLL_MS));
+            continue;
+        }
+
+        TickType_t start = xTaskGetTickCount();
+        ulTaskNotifyTake(pdTRUE, 0);  // drop any stale notification
+        led_panel_request_frame(&current, stream_task);
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(FRAME_WAIT_MS)) == 0) {
+            // No refresh yet. Withdraw the request so a late one can't copy
+            // into current while it is encoded; if a refresh already took it,
+            // wait for its copy to finish instead.
+            if (led_panel_cancel_frame_request()) continue;
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+
+        for (int i = 0; i < FRAME_STREAM_MAX_CLIENTS; i++) {
+            send_to_client(i);
+        }
+
+        TickType_t elapsed = xTaskGetTickCount() - start;
+        if (elapsed < period) vTaskDelay(period - elapsed);
+    }
+}
+
+static esp_err_t ensure_started(void)
+{
+    if (stream_task) return ESP_OK;
+
+    clients_mutex = xSemaphoreCreateMutex();
+    if (!clients_mutex) return ESP_ERR_NO_MEM;
+    for (int i = 0; i < FRAME_STREAM_MAX_CLIENTS; i++) {
+        clients[i].fd = -1;
+    }
+
+    // Low priority on the network core: a slow client only delays the
+    // preview, never the display loop.
+    if (xTaskCreatePinnedToCore(frame_stream_task, "frame_stream", 3072, NULL, 2,
+                                &stream_task, FRAME_STREAM_TASK_CORE) != pdPASS) {
+        vSemaphoreDelete(clients_mutex);
+        clients_mutex = NULL;
+        stream_task = NULL;
+        ESP_LOGE(TAG, "Failed to start frame stream task");
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+esp_err_t frame_stream_add_client(httpd_handle_t server, int fd, int fps)
+{
+    esp_err_t err = ensure_started();
+    if (err != ESP_OK) return err;
+
+    if (fps < 1) fps = 1;
+    if (fps > FRAME_STREAM_MAX_FPS) fps = FRAME_STREAM_MAX_FPS;
+
+    xSemaphoreTake(clients_mutex, portMAX_DELAY);
+    int slot = -1;
+    for (int i = 0; i < FRAME_STREAM_MAX_CLIENTS; i++) {
+        if (clients[i].fd == fd) {
+            slot = i;
+            break;
+        }
+        if (clients[i].fd < 0 && slot < 0) slot = i;
+    }
+    if (slot >= 0) {
+        clients[slot].server = server;
+        clients[slot].fd = fd;
+        clients[slot].period = pdMS_TO_TICKS(1000 / fps);
+        if (clients[slot].period == 0) clients[slot].period = 1;
+        clients[slot].next_due = xTaskGetTickCount();
+        clients[slot].need_keyframe = true;
+    }
+    xSemaphoreGive(clients_mutex);
+
+    if (slot < 0) {
+        ESP_LOGW(TAG, "No free preview slot for fd %d", fd);
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "Client fd %d streaming at %d fps", fd, fps);
+    return ESP_OK;
+}
+
+void frame_stream_remove_all(void)
+{
+    if (!clients_mutex) return;
+    xSemaphoreTake(clients_mutex, portMAX_DELAY);
+    for (int i = 0; i < FRAME_STREAM_MAX_CLIENTS; i++) {
+        clients[i].fd = -1;
+    }
+    xSemaphoreGive(clients_mutex);
+}
@@ -0,0 +1,348 @@
+#include "json_stream.h"
+#include <string.h>
+
+enum {
+    ST_VALUE,          // expecting a value
+    ST_VALUE_OR_END,   // after '[': value or ']'
+    ST_KEY_OR_END,     // after '{': key or '}'
+    ST_KEY,            // after ',' in an object: key
+    ST_COLON,
+    ST_AFTER_VALUE,    // ',' or closing bracket
+    ST_STRING,
+    ST_STRING_ESCAPE,
+    ST_STRING_UNICODE,
+    ST_LITERAL,
+};
+
+static bool is_ws(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static bool is_literal_char(char c)
+{
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') ||
+           c == '-' || c == '+' || c == '.' || c == 'E';
+}
+
+static void path_truncate(json_stream_t *js, int len)
+{
+    js->path[len] = '\0';
+}
+
+static void path_append(json_stream_t *js, const char *segment, bool dotted)
+{
+    size_t len = strlen(js->path);
+    size_t seg_len = strlen(segment);
+    size_t need = seg_len + (dotted ? 1 : 0);
+
+    if (len + need > JSON_STREAM_MAX_PATH) {
+        // Too deep to name: leave a marker no caller path can match.
+        if (len < JSON_STREAM_MAX_PATH) {
+            js->path[len] = '~';
+            js->path[len + 1] = '\0';
+        }
+        return;
+    }
+    if (dotted) js->path[len++] = '.';
+    memcpy(js->path + len, segment, seg_len + 1);
+}
+
+// Point js->path at the value about to start in the current container.
+static void begin_value_path(json_stream_t *js)
+{
+    path_truncate(js, js->path_len[js->depth]);
+    if (js->depth == 0) return;
+
+    int top = js->depth - 1;
+    if (js->container[top] == '[') {
+        js->index[top]++;
+        path_append(js, "[]", false);
+    } else {
+        path_append(js, js->key, js->path[0] != '\0');
+    }
+}
+
+static bool emit(json_stream_t *js, json_stream_event_t event, const char *value, int value_len)
+{
+    if (!js->cb(js->ctx, event, js->path, value, value_len)) {
+        js->status = JSON_STREAM_STOPPED;
+        return false;
+    }
+    return true;
+}
+
+static void value_done(json_stream_t *js)
+{
+    js->state = ST_AFTER_VALUE;
+    if (js->depth == 0) js->done = true;
+}
+
+static bool open_container(json_stream_t *js, char kind)
+{
+    if (js->depth >= JSON_STREAM_MAX_DEPTH) {
+        js->status = JSON_STREAM_ERROR;
+        return false;
+    }
+    begin_value_path(js);
+    js->container[js->depth] = kind;
+    js->index[js->depth] = -1;
+    js->depth++;
+    js->path_len[js->depth] = (uint8_t)strlen(js->path);
+    js->state = (kind == '{') ? ST_KEY_OR_END : ST_VALUE_OR_END;
+    return emit(js, kind == '{' ? JSON_STREAM_OBJECT_START : JSON_STREAM_ARRAY_START, "", 0);
+}
+
+static bool close_container(json_stream_t *js, char closer)
+{
+    char kind = (closer == '}') ? '{' : '[';
+    if (js->depth == 0 || js->container[js->depth - 1] != kind) {
+        js->status = JSON_STREAM_ERROR;
+        return false;
+    }
+    path_truncate(js, js->path_len[js->depth]);
+    js->depth--;
+    value_done(js);
+    return emit(js, kind == '{' ? JSON_STREAM_OBJECT_END : JSON_STREAM_ARRAY_END, "", 0);
+}
+
+static void text_append(json_stream_t *js, char c)
+{
+    if (js->in_key) {
+        // One past the limit records that the key did not fit.
+        if (js->key_len < JSON_STREAM_MAX_KEY) js->key[js->key_len] = c;
+        if (js->key_len <= JSON_STREAM_MAX_KEY) js->key_len++;
+    } else {
+        if (js->value_len < JSON_STREAM_MAX_VALUE) js->value[js->value_len++] = c;
+    }
+}
+
+// Append a \uXXXX code point as UTF-8 (surrogate pairs become '?').
+static void text_append_codepoint(json_stream_t *js, uint16_t cp)
+{
+    if (cp < 0x80) {
+        text_append(js, (char)cp);
+    } else if (cp < 0x800) {
+        text_append(js, (char)(0xC0 | (cp >> 6)));
+        text_append(js, (char)(0x80 | (cp & 0x3F)));
+    } else if (cp >= 0xD800 && cp <= 0xDFFF) {
+        text_append(js, '?');
+    } else {
+        text_append(js, (char)(0xE0 | (cp >> 12)));
+        text_append(js, (char)(0x80 | ((cp >> 6) & 0x3F)));
+        text_append(js, (char)(0x80 | (cp & 0x3F)));
+    }
+}
+
+static bool finish_string(json_stream_t *js)
+{
+    if (js->in_key) {
+        if (js->key_len > JSON_STREAM_MAX_KEY) {
+            // A cut-short key could alias a shorter one; name it like an
+            // over-deep path instead, which no caller path can match.
+            js->key_len = 1;
+            js->key[0] = '~';
+        }
+        js->key[js->key_len] = '\0';
+        js->in_key = false;
+        js->state = ST_COLON;
+        return true;
+    }
+
+    js->value[js->value_len] = '\0';
+    begin_value_path(js);
+    value_done(js);
+    return emit(js, JSON_STREAM_STRING, js->value, js->value_len);
+}
+
+static bool finish_literal(json_stream_t *js)
+{
+    js->value[js->value_len] = '\0';
+
+    json_stream_event_t event;
+    if (strcmp(js->value, "true") == 0) {
+        event = JSON_STREAM_TRUE;
+    } else if (strcmp(js->value, "false") == 0) {
+        event = JSON_STREAM_FALSE;
+    } else if (strcmp(js->value, "null") == 0) {
+        event = JSON_STREAM_NULL;
+    } else if (js->value[0] == '-' || (js->value[0] >= '0' && js->value[0] <= '9')) {
+        event = JSON_STREAM_NUMBER;
+    } else {
+        js->status = JSON_STREAM_ERROR;
+        return false;
+    }
+
+    begin_value_path(js);
+    value_done(js);
+    return emit(js, event, js->value, js->value_len);
+}
+
+static void start_string(json_stream_t *js, bool key)
+{
+    js->in_key = key;
+    if (key) {
+        js->key_len = 0;
+    } else {
+        js->value_len = 0;
+    }
+    js->state = ST_STRING;
+}
+
+static bool start_value(json_stream_t *js, char c)
+{
+    if (c == '{' || c == '[') return open_container(js, c);
+    if (c == '"') {
+        start_string(js, false);
+        return true;
+    }
+    if (c == '-' || (c >= '0' && c <= '9') || c == 't' || c == 'f' || c == 'n') {
+        js->value_len = 0;
+        js->value[js->value_len++] = c;
+        js->state = ST_LITERAL;
+        return true;
+    }
+    js->status = JSON_STREAM_ERROR;
+    return false;
+}
+
+static int hex_value(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Process one character; returns false when parsing must stop.
+static bool step(json_stream_t *js, char c)
+{
+    switch (js->state) {
+    case ST_VALUE:
+        if (is_ws(c)) return true;
+        return start_value(js, c);
+
+    case ST_VALUE_OR_END:
+        if (is_ws(c)) return true;
+        if (c == ']') return close_container(js, c);
+        return start_value(js, c);
+
+    case ST_KEY_OR_END:
+        if (is_ws(c)) return true;
+        if (c == '}') return close_container(js, c);
+        /* fall through */
+    case ST_KEY:
+        if (is_ws(c)) return true;
+        if (c != '"') break;
+        start_string(js, true);
+        return true;
+
+    case ST_COLON:
+        if (is_ws(c)) return true;
+        if (c != ':') break;
+        js->state = ST_VALUE;
+        return true;
+
+    case ST_AFTER_VALUE:
+        if (is_ws(c)) return true;
+        if (js->depth == 0) break;  // trailing garbage after the document
+        if (c == ',') {
+            js->state = (js->container[js->depth - 1] == '{') ? ST_KEY : ST_VALUE;
+            return true;
+        }
+        if (c == '}' || c == ']') return close_container(js, c);
+        break;
+
+    case ST_STRING:
+        if (c == '"') return finish_string(js);
+        if (c == '\\') {
+            js->state = ST_STRING_ESCAPE;
+            return true;
+        }
+        text_append(js, c);
+        return true;
+
+    case ST_STRING_ESCAPE:
+        js->state = ST_STRING;
+        switch (c) {
+        case 'n': text_append(js, '\n'); return true;
+        case 't': text_append(js, '\t'); return true;
+        case 'r': text_append(js, '\r'); return true;
+        case 'b': text_append(js, '\b'); return true;
+        case 'f': text_append(js, '\f'); return true;
+        case 'u':
+            js->unicode_digits = 0;
+            js->unicode_value = 0;
+            js->state = ST_STRING_UNICODE;
+            return true;
+        default:
+            text_append(js, c);  // \" \\ \/
+            return true;
+        }
+
+    case ST_STRING_UNICODE: {
+        int v = hex_value(c);
+        if (v < 0) break;
+        js->unicode_value = (uint16_t)((js->unicode_value << 4) | v);
+        if (++js->unicode_digits == 4) {
+            text_append_codepoint(js, js->unicode_value);
+            js->state = ST_STRING;
+        }
+        return true;
+    }
+
+    case ST_LITERAL:
+        if (is_literal_char(c)) {
+            if (js->value_len < JSON_STREAM_MAX_VALUE) js->value[js->value_len++] = c;
+            return true;
+        }
+        if (!finish_literal(js)) return false;
+        return step(js, c);
+
+    default:
+        break;
+    }
+
+    js->status = JSON_STREAM_ERROR;
+    return false;
+}
+
+void json_stream_init(json_stream_t *js, json_stream_cb_t cb, void *ctx)
+{
+    memset(js, 0, sizeof(*js));
+    js->cb = cb;
+    js->ctx = ctx;
+    js->status = JSON_STREAM_OK;
+    js->state = ST_VALUE;
+}
+
+json_stream_status_t json_stream_feed(json_stream_t *js, const char *data, size_t len)
+{
+    for (size_t i = 0; i < len && js->status == JSON_STREAM_OK; i++) {
+        step(js, data[i]);
+    }
+    return js->status;
+}
+
+json_stream_status_t json_stream_finish(json_stream_t *js)
+{
+    if (js->status != JSON_STREAM_OK) return js->status;
+
+    // A bare number at the root has no terminator.
+    if (js->state == ST_LITERAL && js->depth == 0) {
+        finish_literal(js);
+        if (js->status != JSON_STREAM_OK) return js->status;
+    }
+    if (!js->done) {
+        js->status = JSON_STREAM_ERROR;
+    }
+    return js->status;
+}
+
+int json_stream_array_index(const json_stream_t *js)
+{
+    for (int d = js->depth - 1; d >= 0; d--) {
+        if (js->container[d] == '[') return js->index[d];
+    }
+    return -1;
+}
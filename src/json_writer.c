@@ -0,0 +1,188 @@
+#include "json_writer.h"
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+static void flush_buffer(json_writer_t *w)
+{
+    if (w->failed || w->len == 0) return;
+    if (!w->flush(w->ctx, w->buf, w->len)) {
+        w->failed = true;
+    }
+    w->len = 0;
+}
+
+static void put_bytes(json_writer_t *w, const char *data, size_t len)
+{
+    while (len > 0 && !w->failed) {
+        if (w->len == w->size) flush_buffer(w);
+        size_t room = w->size - w->len;
+        size_t n = len < room ? len : room;
+        memcpy(w->buf + w->len, data, n);
+        w->len += n;
+        data += n;
+        len -= n;
+    }
+}
+
+static void put_char(json_writer_t *w, char c)
+{
+    put_bytes(w, &c, 1);
+}
+
+// Comma before every value but the first in its container (a member's
+// comma goes before its key instead).
+static void begin_value(json_writer_t *w)
+{
+    if (w->after_key) {
+        w->after_key = false;
+        return;
+    }
+    if (w->depth > 0) {
+        if (w->has_value[w->depth - 1]) put_char(w, ',');
+        w->has_value[w->depth - 1] = true;
+    }
+}
+
+static void put_escaped(json_writer_t *w, const char *s)
+{
+    put_char(w, '"');
+    const char *run = s;
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        put_bytes(w, run, s - run);
+        run = s + 1;
+        switch (c) {
+        case '"':  put_bytes(w, "\\\"", 2); break;
+        case '\\': put_bytes(w, "\\\\", 2); break;
+        case '\n': put_bytes(w, "\\n", 2); break;
+        case '\r': put_bytes(w, "\\r", 2); break;
+        case '\t': put_bytes(w, "\\t", 2); break;
+        default: {
+            char esc[7];
+            snprintf(esc, sizeof(esc), "\\u%04x", c);
+            put_bytes(w, esc, 6);
+            break;
+        }
+        }
+    }
+    put_bytes(w, run, s - run);
+    put_char(w, '"');
+}
+
+static void open_container(json_writer_t *w, char opener)
+{
+    begin_value(w);
+    if (w->depth >= JSON_WRITER_MAX_DEPTH) {
+        w->failed = true;
+        return;
+    }
+    w->has_value[w->depth++] = false;
+    put_char(w, opener);
+}
+
+static void close_container(json_writer_t *w, char closer)
+{
+    if (w->depth == 0) {
+        w->failed = true;
+        return;
+    }
+    w->depth--;
+    put_char(w, closer);
+}
+
+void json_writer_init(json_writer_t *w, char *buf, size_t size,
+                      json_writer_flush_cb_t flush, void *ctx)
+{
+    memset(w, 0, sizeof(*w));
+    w->buf = buf;
+    w->size = size;
+    w->flush = flush;
+    w->ctx = ctx;
+    w->failed = (buf == NULL || size == 0 || flush == NULL);
+}
+
+void json_writer_object_start(json_writer_t *w)
+{
+    open_container(w, '{');
+}
+
+void json_writer_object_end(json_writer_t *w)
+{
+    close_container(w, '}');
+}
+
+void json_writer_array_start(json_writer_t *w)
+{
+    open_container(w, '[');
+}
+
+void json_writer_array_end(json_writer_t *w)
+{
+    close_container(w, ']');
+}
+
+void json_writer_key(json_writer_t *w, const char *key)
+{
+    begin_value(w);
+    put_escaped(w, key);
+    put_char(w, ':');
+    w->after_key = true;
+}
+
+void json_writer_string(json_writer_t *w, const char *value)
+{
+    begin_value(w);
+    put_escaped(w, value ? value : "");
+}
+
+void json_writer_int(json_writer_t *w, int64_t value)
+{
+    char num[24];
+    int len = snprintf(num, sizeof(num), "%" PRId64, value);
+    begin_value(w);
+    put_bytes(w, num, len);
+}
+
+void json_writer_bool(json_writer_t *w, bool value)
+{
+    begin_value(w);
+    if (value) {
+        put_bytes(w, "true", 4);
+    } else {
+        put_bytes(w, "false", 5);
+    }
+}
+
+void json_writer_null(json_writer_t *w)
+{
+    begin_value(w);
+    put_bytes(w, "null", 4);
+}
+
+void json_writer_kv_string(json_writer_t *w, const char *key, const char *value)
+{
+    json_writer_key(w, key);
+    json_writer_string(w, value);
+}
+
+void json_writer_kv_int(json_writer_t *w, const char *key, int64_t value)
+{
+    json_writer_key(w, key);
+    json_writer_int(w, value);
+}
+
+void json_writer_kv_bool(json_writer_t *w, const char *key, bool value)
+{
+    json_writer_key(w, key);
+    json_writer_bool(w, value);
+}
+
+bool json_writer_finish(json_writer_t *w)
+{
+    if (w->depth != 0 || w->after_key) w->failed = true;
+    flush_buffer(w);
+    return !w->failed;
+}
@@ -1,11 +1,15 @@
 #define FASTLED_LEAN_AND_MEAN 1
 #include <FastLED.h>
+#include <atomic>
 #include <cstring>
 
 #include "esp_log.h"
+#include "esp_timer.h"
 
 extern "C" {
 #include "led_panel.h"
+#include "metrics.h"
+#include "trace.h"
 }
 
 static const char *TAG = "led_panel";
@@ -15,6 +19,10 @@ static CRGB leds[PANEL_MAX_LEDS];
 static uint8_t global_brightness = 32;
 static uint8_t panel_cols = 32;
 static bool initialized = false;
+static led_panel_stats_t stats;
+static int64_t last_refresh_us = 0;
+static std::atomic<led_panel_frame_t *> frame_request{nullptr};
+static TaskHandle_t frame_request_task = NULL;
 
 // Convert (row, col) to linear LED index for column-major serpentine layout.
 // Data enters top-left, snakes down col 0, up col 1, down col 2, etc.
@@ -70,6 +78,26 @@ extern "C" pixel_rgb_t led_panel_get_pixel(int row, int col) {
     return framebuffer[row][col];
 }
 
+// WS2812: 24 bits at 1.25 us each, plus the 50 us latch.
+static inline uint32_t wire_time_us(void) {
+    return (uint32_t)active_led_count() * 30 + 50;
+}
+
+static void record_refresh(int64_t start_us, int64_t end_us) {
+    uint32_t show_us = (uint32_t)(end_us - start_us);
+    stats.refresh_count++;
+    if (show_us > stats.max_refresh_us) stats.max_refresh_us = show_us;
+    if (show_us > wire_time_us() + LED_PANEL_SLOW_REFRESH_US) stats.slow_refreshes++;
+
+    if (last_refresh_us != 0) {
+        uint32_t gap_ms = (uint32_t)((start_us - last_refresh_us) / 1000);
+        if (gap_ms > stats.max_gap_ms) stats.max_gap_ms = gap_ms;
+        if (gap_ms > LED_PANEL_STALL_MS) stats.stalls++;
+        metrics_observe_frame_interval_us(static_cast<uint32_t>(start_us - last_refresh_us));
+    }
+    last_refresh_us = start_us;
+}
+
 extern "C" esp_err_t led_panel_refresh(void) {
     for (int row = 0; row < PANEL_ROWS; row++) {
         for (int col = 0; col < panel_cols; col++) {
@@ -78,7 +106,19 @@ extern "C" esp_err_t led_panel_refresh(void) {
         }
     }
 
+    trace_begin(TRACE_CAT_RENDER, "led_show", panel_cols);
+    int64_t start_us = esp_timer_get_time();
     FastLED.show();
+    int64_t end_us = esp_timer_get_time();
+    trace_end(TRACE_CAT_RENDER, "led_show", 0);
+    record_refresh(start_us, end_us);
+
+    led_panel_frame_t *dst = frame_request.exchange(nullptr);
+    if (dst) {
+        dst->cols = panel_cols;
+        std::memcpy(dst->px, framebuffer, sizeof(dst->px));
+        xTaskNotifyGive(frame_request_task);
+    }
     return ESP_OK;
 }
 
@@ -104,3 +144,17 @@ extern "C" void led_panel_set_cols(uint8_t cols) {
 extern "C" uint8_t led_panel_get_cols(void) {
     return panel_cols;
 }
+
+extern "C" void led_panel_request_frame(led_panel_frame_t *dst, TaskHandle_t task) {
+    frame_request_task = task;
+    frame_request.store(dst);
+}
+
+extern "C" bool led_panel_cancel_frame_request(void) {
+    return frame_request.exchange(nullptr) != nullptr;
+}
+
+extern "C" void led_panel_get_stats(led_panel_stats_t *out) {
+    if (!out) return;
+    *out = stats;
+}
@@ -1,9 +1,12 @@
 #include <stdio.h>
 #include <string.h>
+#include <stdatomic.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/event_groups.h"
 #include "nvs_flash.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "esp_littlefs.h"
 #include "driver/gpio.h"
 #include "led_panel.h"
@@ -15,13 +18,27 @@
 #include "web_server.h"
 #include "rss_fetcher.h"
 #include "rss_cache.h"
+#include "rss_scheduler.h"
+#include "boot_profile.h"
+#include "realtime_ingest.h"
+#include "metrics.h"
+#include "trace.h"
+#include "deferred_log.h"
 
 static const char *TAG = "main";
 
 #define CONFIG_BUTTON_GPIO 0
 
-#define RSS_REFRESH_INTERVAL_MS (15 * 60 * 1000)
-#define RSS_REFRESH_RETRY_MS    (60 * 1000)
+// A fetch given less time than this would only time out; defer it instead.
+#define RSS_REFRESH_MIN_REQUEST_MS 2000
+
+// Background refreshes run on core 0 with the WiFi and lwIP tasks; app_main
+// is pinned to core 1 (sdkconfig) so LED output never waits on the network.
+#define RSS_REFRESH_TASK_CORE 0
+
+// How long one loop pass waits for a realtime frame before rechecking the
+// button and settings.
+#define REALTIME_FRAME_WAIT_MS 50
 
 static volatile bool config_button_pressed = false;
 static volatile uint32_t last_button_tick = 0;
@@ -31,7 +48,22 @@ static rss_item_t rss_item;
 static int rss_item_source_idx = -1;
 static bool rss_item_live = false;
 static bool rss_showing_title = true;
-static TickType_t rss_next_refresh_tick = 0;
+
+// Set by app_main once settings are loaded and the scroller is up; the
+// network start task waits for it before wifi_manager_start().
+#define BOOT_DISPLAY_READY_BIT BIT0
+
+static EventGroupHandle_t boot_events = NULL;
+static volatile bool network_ready = false;
+
+// Field groups committed by the web server since the display loop last
+// looked; the loop applies them on its next frame.
+static atomic_uint pending_settings_fields = 0;
+
+static app_settings_t rss_refresh_job;
+static TaskHandle_t rss_refresh_task_handle = NULL;
+static volatile bool rss_refresh_done = false;
+static volatile bool rss_refresh_result = false;
 
 static const uint8_t rss_colors[][3] = {
     {255, 255, 255},
@@ -122,6 +154,33 @@ static void load_custom_or_prompt(const app_settings_t *s, int *current_msg, con
     }
 }
 
+static void on_settings_changed(const app_settings_t *snapshot, uint32_t fields, void *ctx)
+{
+    (void)snapshot;
+    (void)ctx;
+    atomic_fetch_or(&pending_settings_fields, fields);
+}
+
+// Apply render settings from s at once. shown_msg is the custom message on
+// screen (-1 if none), whose color follows edits; text and feed changes
+// wait for the next item boundary.
+static void apply_live_settings(const app_settings_t *s, uint32_t fields, int shown_msg)
+{
+    if (fields & SETTINGS_FIELD_SPEED) {
+        scroller_set_speed(s->speed);
+    }
+    if (fields & SETTINGS_FIELD_BRIGHTNESS) {
+        led_panel_set_brightness(s->brightness);
+    }
+    if (fields & SETTINGS_FIELD_PANEL) {
+        led_panel_set_cols(s->panel_cols);
+    }
+    if ((fields & SETTINGS_FIELD_MESSAGES) && shown_msg >= 0 && shown_msg < MAX_MESSAGES) {
+        const message_t *m = &s->messages[shown_msg];
+        scroller_set_color(m->color_r, m->color_g, m->color_b);
+    }
+}
+
 static int rss_source_count(const app_settings_t *s)
 {
     int count = s->rss_source_count;
@@ -207,7 +266,7 @@ static bool rss_pick_random_cached_item(const app_settings_t *s)
     }
 
     if (cycle_reset) {
-        ESP_LOGI(TAG, "RSS random cycle exhausted; restarting pool");
+        DLOGI(TAG, "RSS random cycle exhausted; restarting pool");
     }
 
     rss_item = selected;
@@ -233,10 +292,11 @@ static bool rss_show_current_item_segment(void)
     if (rss_showing_title) {
         // Future hot-list scheduling can use rss_item_live to prioritize in-progress games.
         if (rss_item_live) {
-            ESP_LOGD(TAG, "Showing LIVE feed item from source index %d", rss_item_source_idx);
+            DLOGD(TAG, "Showing LIVE feed item from source index %d", rss_item_source_idx);
         }
         scroller_set_text(rss_item.title[0] ? rss_item.title : "(no title)");
         rss_showing_title = false;
+        boot_profile_mark(BOOT_STAGE_FIRST_HEADLINE);
     } else {
         scroller_set_text(rss_item.description[0] ? rss_item.description : "(no description)");
         rss_showing_title = true;
@@ -254,7 +314,27 @@ static bool rss_prepare_next_display_item(const app_settings_t *s)
     return rss_show_current_item_segment();
 }
 
-static bool rss_refresh_cache(const app_settings_t *s)
+static esp_err_t rss_fetch_source(const rss_source_t *source, uint32_t timeout_ms,
+                                  int64_t deadline_us)
+{
+    rss_fetch_options_t options = {
+        .timeout_ms = timeout_ms,
+        .deadline_us = deadline_us,
+    };
+    if (source->type == RSS_SOURCE_TYPE_JSON) {
+        options.json_title_path = source->json_title_path;
+        options.json_desc_path = source->json_desc_path;
+    }
+    return rss_fetch_ex(source->url, &options);
+}
+
+// Fetch the sources whose refresh deadline has come (see rss_scheduler.c),
+// within the configured wall-clock budget so the display never stalls longer
+// than rss_refresh_budget_s. Sources that don't fit wait for the next window.
+// With show_status the panel shows "Updating feeds..." for the duration;
+// background refreshes leave the display alone.
+// Returns true when cached items are available for display.
+static bool rss_refresh_cache(const app_settings_t *s, bool show_status)
 {
     if (!rss_sources_available(s)) {
         return false;
@@ -263,66 +343,225 @@ static bool rss_refresh_cache(const app_settings_t *s)
         return rss_cache_available_for_enabled_sources(s);
     }
 
-    scroller_set_text("Updating feeds...");
-    scroller_set_color(255, 255, 255);
-    scroller_tick(NULL);
+    TickType_t now = xTaskGetTickCount();
+    rss_scheduler_sync(s, now);
+
+    int plan[MAX_RSS_SOURCES];
+    int due_sources = rss_scheduler_plan(s, now, plan, MAX_RSS_SOURCES);
+    if (due_sources == 0) {
+        return rss_cache_available_for_enabled_sources(s);
+    }
+
+    trace_begin(TRACE_CAT_REFRESH, "rss_refresh_cache", due_sources);
+    int64_t window_start_us = esp_timer_get_time();
+    int64_t window_end_us = window_start_us + (int64_t)s->rss_refresh_budget_s * 1000000;
+
+    if (show_status) {
+        scroller_set_text("Updating feeds...");
+        scroller_set_color(255, 255, 255);
+        scroller_tick(NULL);
+    }
 
     if (!wifi_manager_radio_on()) {
         ESP_LOGW(TAG, "WiFi connect failed for RSS refresh");
         wifi_manager_radio_off();
+        rss_scheduler_defer_due(now, RSS_SCHED_RETRY_MS);
+        trace_end(TRACE_CAT_REFRESH, "rss_refresh_cache", -1);
         return rss_cache_available_for_enabled_sources(s);
     }
 
-    int count = rss_source_count(s);
     int fetched_sources = 0;
     int cached_sources = 0;
+    int deferred_sources = 0;
 
-    for (int i = 0; i < count; i++) {
-        if (!rss_source_enabled(s, i)) continue;
+    for (int k = 0; k < due_sources; k++) {
+        const rss_source_t *source = &s->rss_sources[plan[k]];
 
-        ESP_LOGI(TAG, "Refreshing source %d/%d: %s", i + 1, count, s->rss_sources[i].name);
-        esp_err_t fetch_err = rss_fetch(s->rss_sources[i].url);
+        int64_t remaining_ms = (window_end_us - esp_timer_get_time()) / 1000;
+        if (remaining_ms < RSS_REFRESH_MIN_REQUEST_MS) {
+            for (int rest = k; rest < due_sources; rest++) {
+                rss_scheduler_defer(s->rss_sources[plan[rest]].url, xTaskGetTickCount(),
+                                    RSS_SCHED_RETRY_MS);
+            }
+            deferred_sources = due_sources - k;
+            break;
+        }
+        uint32_t timeout_ms = RSS_FETCH_DEFAULT_TIMEOUT_MS;
+        if (remaining_ms < timeout_ms) timeout_ms = (uint32_t)remaining_ms;
+
+        ESP_LOGI(TAG, "Refreshing source %d/%d: %s (%lld ms left)", k + 1, due_sources,
+                 source->name, (long long)remaining_ms);
+        trace_begin(TRACE_CAT_REFRESH, "fetch_source", plan[k]);
+        int64_t fetch_start_us = esp_timer_get_time();
+        esp_err_t fetch_err = rss_fetch_source(source, timeout_ms, window_end_us);
+        metrics_observe_fetch(source->url, (uint32_t)(esp_timer_get_time() - fetch_start_us),
+                              rss_get_last_fetch_bytes(), fetch_err == ESP_OK);
+        esp_err_t cache_err = ESP_FAIL;
         if (fetch_err == ESP_OK && rss_get_count() > 0) {
             fetched_sources++;
-            esp_err_t cache_err = rss_cache_store_from_fetcher(
-                s->rss_sources[i].url, s->rss_sources[i].name);
+            cache_err = rss_cache_store_from_fetcher(source->url, source->name);
             if (cache_err == ESP_OK) {
                 cached_sources++;
             } else {
                 ESP_LOGW(TAG, "Cache write failed for '%s': %s",
-                         s->rss_sources[i].name, esp_err_to_name(cache_err));
+                         source->name, esp_err_to_name(cache_err));
             }
         } else {
             ESP_LOGW(TAG, "Feed refresh failed for '%s': %s",
-                     s->rss_sources[i].name, esp_err_to_name(fetch_err));
+                     source->name, esp_err_to_name(fetch_err));
         }
+
+        rss_cache_source_info_t info = {0};
+        if (cache_err == ESP_OK) {
+            cache_err = rss_cache_get_source_info(source->url, &info);
+        }
+        if (cache_err == ESP_OK) {
+            rss_scheduler_record_success(source->url, &info, xTaskGetTickCount());
+        } else if (fetch_err == ESP_ERR_TIMEOUT && k > 0) {
+            // Cut short by the window budget after sharing it; not the source's fault.
+            rss_scheduler_defer(source->url, xTaskGetTickCount(), RSS_SCHED_RETRY_MS);
+            deferred_sources++;
+        } else {
+            esp_err_t err = (fetch_err != ESP_OK) ? fetch_err : cache_err;
+            rss_scheduler_record_failure(source->url, err, xTaskGetTickCount());
+        }
+        trace_end(TRACE_CAT_REFRESH, "fetch_source", cache_err);
     }
 
     wifi_manager_radio_off();
 
     bool cache_ready = rss_cache_available_for_enabled_sources(s);
-    ESP_LOGI(TAG, "RSS refresh complete: fetched=%d cached=%d cache_ready=%d",
-             fetched_sources, cached_sources, cache_ready);
+    trace_end(TRACE_CAT_REFRESH, "rss_refresh_cache", cached_sources);
+    ESP_LOGI(TAG, "RSS refresh complete in %lld ms (budget %u s): due=%d fetched=%d cached=%d "
+             "deferred=%d cache_ready=%d",
+             (long long)((esp_timer_get_time() - window_start_us) / 1000),
+             (unsigned)s->rss_refresh_budget_s, due_sources, fetched_sources, cached_sources,
+             deferred_sources, cache_ready);
+
+    led_panel_stats_t ps;
+    led_panel_get_stats(&ps);
+    ESP_LOGI(TAG, "Display since boot: frames=%u slow=%u (max %u us) stalls=%u (max gap %u ms)",
+             (unsigned)ps.refresh_count, (unsigned)ps.slow_refreshes,
+             (unsigned)ps.max_refresh_us, (unsigned)ps.stalls, (unsigned)ps.max_gap_ms);
     return cache_ready;
 }
 
+static void rss_refresh_task(void *arg)
+{
+    (void)arg;
+    rss_refresh_result = rss_refresh_cache(&rss_refresh_job, false);
+    rss_refresh_done = true;
+    vTaskDelete(NULL);
+}
+
+// Run rss_refresh_cache() on a snapshot of the settings in a task on core 0.
+// The result is picked up with rss_refresh_collect().
+static void rss_refresh_start_background(const app_settings_t *s)
+{
+    if (rss_refresh_task_handle) return;
+
+    rss_refresh_job = *s;
+    rss_refresh_done = false;
+    if (xTaskCreatePinnedToCore(rss_refresh_task, "rss_refresh", 6144, NULL, 3,
+                                &rss_refresh_task_handle, RSS_REFRESH_TASK_CORE) != pdPASS) {
+        rss_refresh_task_handle = NULL;
+        ESP_LOGW(TAG, "Failed to start background RSS refresh");
+    }
+}
+
+// Returns true once a background refresh has finished, with its result in *cache_ready.
+static bool rss_refresh_collect(bool *cache_ready)
+{
+    if (!rss_refresh_task_handle || !rss_refresh_done) return false;
+    rss_refresh_task_handle = NULL;
+    *cache_ready = rss_refresh_result;
+    return true;
+}
+
+// Copy a realtime frame (column-major RGB, see realtime_ingest.h) to the panel.
+static void show_realtime_frame(const uint8_t *rgb)
+{
+    int cols = led_panel_get_cols();
+    for (int col = 0; col < cols; col++) {
+        for (int row = 0; row < PANEL_ROWS; row++) {
+            const uint8_t *px = rgb + (col * PANEL_ROWS + row) * 3;
+            led_panel_set_pixel(row, col, px[0], px[1], px[2]);
+        }
+    }
+    led_panel_refresh();
+}
+
+// Keep scrolling until a background refresh has released the radio.
+static void rss_refresh_wait(void)
+{
+    bool cache_ready = false;
+    while (rss_refresh_task_handle && !rss_refresh_collect(&cache_ready)) {
+        vTaskDelay(pdMS_TO_TICKS(scroller_tick(NULL)));
+    }
+}
+
+// WiFi bring-up blocks for up to the STA connect timeout (and falls back to
+// AP mode after that), so it runs next to the WiFi task on core 0. Driver
+// and netif init overlap the LittleFS mount and font/cache load in app_main;
+// connecting waits for the settings and the scroller (AP mode sets its text).
+static void network_start_task(void *arg)
+{
+    (void)arg;
+    wifi_manager_init();
+    boot_profile_mark(BOOT_STAGE_WIFI_INIT);
+
+    xEventGroupWaitBits(boot_events, BOOT_DISPLAY_READY_BIT, pdFALSE, pdTRUE, portMAX_DELAY);
+    wifi_manager_start();
+    web_server_start();
+    realtime_ingest_start();
+    boot_profile_mark(BOOT_STAGE_NETWORK);
+    network_ready = true;
+    vTaskDelete(NULL);
+}
+
+// Refresh after config mode. In background mode whatever is
+// already cached plays while the fetch runs; otherwise block until it's done.
+// Returns true when RSS playback started.
+static bool rss_start_playback(const app_settings_t *s)
+{
+    if (s->rss_background_refresh) {
+        bool active = rss_cache_available_for_enabled_sources(s) &&
+                      rss_prepare_next_display_item(s);
+        rss_refresh_start_background(s);
+        return active;
+    }
+    return rss_refresh_cache(s, true) && rss_prepare_next_display_item(s);
+}
+
 void app_main(void)
 {
     ESP_LOGI(TAG, "ManCaveScroller starting...");
+    if (deferred_log_init() != ESP_OK) {
+        ESP_LOGE(TAG, "Deferred log writer unavailable");
+    }
 
     esp_err_t ret = nvs_flash_init();
     if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
         nvs_flash_erase();
         nvs_flash_init();
     }
+    boot_profile_mark(BOOT_STAGE_NVS);
 
-    littlefs_init();
-    if (rss_cache_init() != ESP_OK) {
-        ESP_LOGW(TAG, "RSS cache init failed");
+    boot_events = xEventGroupCreate();
+    if (xTaskCreatePinnedToCore(network_start_task, "net_start", 4096, NULL, 5, NULL,
+                                RSS_REFRESH_TASK_CORE) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to start network task");
     }
 
+    littlefs_init();
+    boot_profile_mark(BOOT_STAGE_LITTLEFS);
+
     settings_init();
-    app_settings_t *settings = settings_get();
+    // The loop keeps one snapshot and swaps it only when the generation moves.
+    uint32_t settings_gen = settings_get_generation();
+    const app_settings_t *settings = settings_acquire();
+    settings_subscribe(on_settings_changed, NULL);
+    boot_profile_mark(BOOT_STAGE_SETTINGS);
 
     ret = led_panel_init();
     if (ret != ESP_OK) {
@@ -331,52 +570,70 @@ void app_main(void)
     }
     led_panel_set_brightness(settings->brightness);
     led_panel_set_cols(settings->panel_cols);
+    boot_profile_mark(BOOT_STAGE_LED_PANEL);
 
     font_init();
+    boot_profile_mark(BOOT_STAGE_FONT);
     scroller_init();
     scroller_set_speed(settings->speed);
 
-    wifi_manager_init();
-    wifi_manager_start();
-    web_server_start();
+    // The ready bit starts the web server, whose status handler reads the
+    // cache and scheduler; both must be initialized first.
+    if (rss_cache_init() != ESP_OK) {
+        ESP_LOGW(TAG, "RSS cache init failed");
+    }
+    if (rss_scheduler_init() != ESP_OK) {
+        ESP_LOGW(TAG, "RSS scheduler init failed");
+    }
+    xEventGroupSetBits(boot_events, BOOT_DISPLAY_READY_BIT);
 
+    // Stale-while-revalidate: play last run's cache (or the custom messages)
+    // now, and fetch in the background once the network is up.
     rss_playback_reset();
-    bool rss_active = false;
+    bool rss_active = rss_sources_available(settings) &&
+                      rss_cache_available_for_enabled_sources(settings) &&
+                      rss_prepare_next_display_item(settings);
 
     int current_msg = -1;
-    wifi_mgr_mode_t mode = wifi_manager_get_mode();
-    ESP_LOGI(TAG, "WiFi mode=%d, rss_enabled=%d, rss_sources=%d",
-             mode, settings->rss_enabled, settings->rss_source_count);
-
-    if (mode == WIFI_MGR_MODE_STA && rss_sources_available(settings)) {
-        rss_active = rss_refresh_cache(settings);
-        if (rss_active) {
-            rss_active = rss_prepare_next_display_item(settings);
-        }
-        TickType_t now = xTaskGetTickCount();
-        rss_next_refresh_tick = now + pdMS_TO_TICKS(
-            rss_active ? RSS_REFRESH_INTERVAL_MS : RSS_REFRESH_RETRY_MS);
-    }
-
     if (!rss_active) {
         load_custom_or_prompt(settings, &current_msg,
                               "No messages     Press button to configure");
     }
+    boot_profile_mark(BOOT_STAGE_DISPLAY);
+    ESP_LOGI(TAG, "Showing %s", rss_active ? "cached feed" : "messages");
 
     config_button_init();
     bool config_mode = false;
+    bool network_started = false;
+    uint32_t boundary_fields = 0;  // content changes waiting for the next item
+    bool realtime_shown = false;
 
     ESP_LOGI(TAG, "ManCaveScroller ready - press BOOT for config mode");
 
     while (1) {
-        if (config_button_pressed) {
+        if (!network_started && network_ready) {
+            network_started = true;
+            wifi_mgr_mode_t mode = wifi_manager_get_mode();
+            ESP_LOGI(TAG, "WiFi mode=%d, rss_enabled=%d, rss_sources=%d",
+                     mode, settings->rss_enabled, settings->rss_source_count);
+
+            // The first refresh always runs in the background, whatever the
+            // refresh mode, so a restart never blanks out a usable cache.
+            if (mode == WIFI_MGR_MODE_STA && rss_sources_available(settings)) {
+                rss_refresh_start_background(settings);
+            }
+        }
+
+        if (config_button_pressed && network_started) {
             config_button_pressed = false;
 
             if (!config_mode && wifi_manager_get_mode() == WIFI_MGR_MODE_STA) {
                 ESP_LOGI(TAG, "BOOT: entering config mode");
                 config_mode = true;
+                rss_refresh_wait();
                 if (wifi_manager_radio_on()) {
                     web_server_start();
+                    realtime_ingest_start();
                     char msg[64];
                     snprintf(msg, sizeof(msg), "Config Mode     %s", wifi_manager_get_ip());
                     scroller_set_text(msg);
@@ -386,24 +643,20 @@ void app_main(void)
             } else if (config_mode) {
                 ESP_LOGI(TAG, "BOOT: exiting config mode");
                 config_mode = false;
+                realtime_ingest_stop();
                 web_server_stop();
                 wifi_manager_radio_off();
+                settings_flush();
 
-                settings = settings_get();
-                scroller_set_speed(settings->speed);
-                led_panel_set_brightness(settings->brightness);
-                led_panel_set_cols(settings->panel_cols);
+                settings_release(settings);
+                settings_gen = settings_get_generation();
+                settings = settings_acquire();
 
+                boundary_fields = 0;
                 rss_active = false;
                 rss_playback_reset();
                 if (wifi_manager_get_mode() == WIFI_MGR_MODE_STA && rss_sources_available(settings)) {
-                    rss_active = rss_refresh_cache(settings);
-                    if (rss_active) {
-                        rss_active = rss_prepare_next_display_item(settings);
-                    }
-                    TickType_t now = xTaskGetTickCount();
-                    rss_next_refresh_tick = now + pdMS_TO_TICKS(
-                        rss_active ? RSS_REFRESH_INTERVAL_MS : RSS_REFRESH_RETRY_MS);
+                    rss_active = rss_start_playback(settings);
                 }
 
                 if (!rss_active) {
@@ -413,24 +666,68 @@ void app_main(void)
             }
         }
 
+        uint32_t changed = atomic_exchange(&pending_settings_fields, 0);
+        uint32_t gen = settings_get_generation();
+        if (gen != settings_gen) {
+            settings_release(settings);
+            settings_gen = gen;
+            settings = settings_acquire();
+        }
+        if (changed) {
+            apply_live_settings(settings, changed,
+                                (config_mode || rss_active) ? -1 : current_msg);
+            boundary_fields |= changed;
+        }
+
+        // PC-driven frames take over the panel; the scroller resumes where
+        // it was once they stop for REALTIME_INGEST_TIMEOUT_MS.
+        if (realtime_ingest_active()) {
+            if (!realtime_shown) {
+                DLOGI(TAG, "Realtime frames arriving, scroller paused");
+                realtime_shown = true;
+            }
+            const uint8_t *rgb;
+            if (realtime_ingest_wait_frame(&rgb, pdMS_TO_TICKS(REALTIME_FRAME_WAIT_MS))) {
+                show_realtime_frame(rgb);
+            }
+            continue;
+        }
+        if (realtime_shown) {
+            DLOGI(TAG, "Realtime frames stopped, resuming scroller");
+            realtime_shown = false;
+        }
+
         bool cycle_done = false;
         int delay_ms = scroller_tick(&cycle_done);
 
         if (cycle_done && !config_mode) {
-            settings = settings_get();
+            bool sources_changed = (boundary_fields & SETTINGS_FIELD_RSS) != 0;
+            boundary_fields = 0;
+            if (sources_changed) {
+                // New sources become due now; removed ones drop out of the plan.
+                rss_scheduler_sync(settings, xTaskGetTickCount());
+            }
 
-            if (wifi_manager_get_mode() == WIFI_MGR_MODE_STA && rss_sources_available(settings)) {
+            bool cache_ready = false;
+            bool refreshed = rss_refresh_collect(&cache_ready);
+            if (!refreshed && !rss_refresh_task_handle && network_started &&
+                wifi_manager_get_mode() == WIFI_MGR_MODE_STA && rss_sources_available(settings)) {
                 TickType_t now = xTaskGetTickCount();
-                if ((int32_t)(now - rss_next_refresh_tick) >= 0) {
-                    bool cache_ready = rss_refresh_cache(settings);
-                    if (cache_ready && !rss_active) {
-                        rss_playback_reset();
-                        rss_active = rss_prepare_next_display_item(settings);
+                if ((int32_t)(now - rss_scheduler_next_due(now)) >= 0) {
+                    if (settings->rss_background_refresh) {
+                        rss_refresh_start_background(settings);
+                    } else {
+                        cache_ready = rss_refresh_cache(settings, true);
+                        refreshed = true;
                     }
-                    rss_next_refresh_tick = now + pdMS_TO_TICKS(
-                        cache_ready ? RSS_REFRESH_INTERVAL_MS : RSS_REFRESH_RETRY_MS);
                 }
             }
+            if (!rss_active && rss_sources_available(settings) &&
+                ((refreshed && cache_ready) ||
+                 (sources_changed && rss_cache_available_for_enabled_sources(settings)))) {
+                rss_playback_reset();
+                rss_active = rss_prepare_next_display_item(settings);
+            }
 
             if (rss_active) {
                 if (!rss_prepare_next_display_item(settings)) {
@@ -0,0 +1,357 @@
+#include "metrics.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_system.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "led_panel.h"
+
+#define METRICS_MAX_BOUNDS 8
+
+typedef struct {
+    atomic_uint buckets[METRICS_MAX_BOUNDS + 1];  // per bucket; last is +Inf
+    atomic_uint count;
+    atomic_uint sum_ms;
+    uint32_t carry_us;  // owned by the histogram's writer
+} histogram_t;
+
+static const uint32_t frame_bounds_us[METRICS_MAX_BOUNDS] = {
+    5000, 10000, 16000, 20000, 33000, 50000, 100000, 250000,
+};
+static const uint32_t fetch_bounds_us[METRICS_MAX_BOUNDS] = {
+    250000, 500000, 1000000, 2000000, 5000000, 10000000, 20000000, 30000000,
+};
+static const uint32_t reconnect_bounds_us[METRICS_MAX_BOUNDS] = {
+    100000, 250000, 500000, 1000000, 2000000, 5000000, 10000000, 20000000,
+};
+
+static atomic_uint counters[METRIC_COUNTER_COUNT];
+static histogram_t frame_hist;
+static histogram_t reconnect_hist;
+static atomic_uint reconnect_failures;
+
+// Fetch metrics are keyed by URL hash rather than by position in the source
+// list, so adding, removing or reordering sources never moves a series to
+// another source's label. Twice the source limit leaves removed sources room
+// to age out before a slot in use is reclaimed.
+#define FETCH_METRIC_SLOTS (2 * MAX_RSS_SOURCES)
+
+typedef struct {
+    atomic_uint url_hash;  // 0 while free or being reset
+    uint32_t last_used;    // owned by the fetch writer
+    histogram_t duration;
+    atomic_uint bytes;
+    atomic_uint failures;
+} fetch_metrics_t;
+
+static fetch_metrics_t fetch_metrics[FETCH_METRIC_SLOTS];
+static uint32_t fetch_sequence;  // owned by the fetch writer
+static histogram_t empty_hist;   // rendered for sources not fetched yet
+
+// Tasks whose stack headroom is reported, when they exist.
+static const char *const stack_tasks[] = {
+    "main", "settings_flush", "rss_refresh", "web_worker", "frame_stream",
+    "realtime_ingest", "dns_server", "httpd", "tiT", "wifi", "sys_evt",
+};
+
+static void observe(histogram_t *h, const uint32_t *bounds_us, uint32_t us)
+{
+    int i = 0;
+    while (i < METRICS_MAX_BOUNDS && us > bounds_us[i]) i++;
+    atomic_fetch_add_explicit(&h->buckets[i], 1, memory_order_relaxed);
+
+    uint32_t total_us = h->carry_us + us;
+    h->carry_us = total_us % 1000;
+    atomic_fetch_add_explicit(&h->sum_ms, total_us / 1000, memory_order_relaxed);
+    atomic_fetch_add_explicit(&h->count, 1, memory_order_relaxed);
+}
+
+void metrics_add(metrics_counter_t counter, uint32_t n)
+{
+    if (counter >= METRIC_COUNTER_COUNT) return;
+    atomic_fetch_add_explicit(&counters[counter], n, memory_order_relaxed);
+}
+
+void metrics_observe_frame_interval_us(uint32_t us)
+{
+    observe(&frame_hist, frame_bounds_us, us);
+}
+
+// FNV-1a, as rss_scheduler keys its entries; never 0, which marks a free slot.
+static uint32_t hash_url(const char *s)
+{
+    uint32_t hash = 2166136261u;
+    while (*s) {
+        hash ^= (uint8_t)*s++;
+        hash *= 16777619u;
+    }
+    return hash ? hash : 1;
+}
+
+static fetch_metrics_t *find_fetch_metrics(uint32_t hash)
+{
+    for (int i = 0; i < FETCH_METRIC_SLOTS; i++) {
+        if (atomic_load_explicit(&fetch_metrics[i].url_hash, memory_order_acquire) == hash) {
+            return &fetch_metrics[i];
+        }
+    }
+    return NULL;
+}
+
+// Slot for hash, reclaiming the least recently used one (a free slot first)
+// when the URL is new. The slot is unlabelled while it is reset.
+static fetch_metrics_t *claim_fetch_metrics(uint32_t hash)
+{
+    fetch_metrics_t *m = find_fetch_metrics(hash);
+    if (!m) {
+        m = &fetch_metrics[0];
+        for (int i = 1; i < FETCH_METRIC_SLOTS; i++) {
+            if (fetch_metrics[i].last_used < m->last_used) m = &fetch_metrics[i];
+        }
+        atomic_store_explicit(&m->url_hash, 0, memory_order_release);
+        for (int b = 0; b <= METRICS_MAX_BOUNDS; b++) {
+            atomic_store_explicit(&m->duration.buckets[b], 0, memory_order_relaxed);
+        }
+        atomic_store_explicit(&m->duration.count, 0, memory_order_relaxed);
+        atomic_store_explicit(&m->duration.sum_ms, 0, memory_order_relaxed);
+        m->duration.carry_us = 0;
+        atomic_store_explicit(&m->bytes, 0, memory_order_relaxed);
+        atomic_store_explicit(&m->failures, 0, memory_order_relaxed);
+        atomic_store_explicit(&m->url_hash, hash, memory_order_release);
+    }
+    m->last_used = ++fetch_sequence;
+    return m;
+}
+
+void metrics_observe_fetch(const char *url, uint32_t duration_us, uint32_t bytes, bool ok)
+{
+    if (!url || url[0] == '\0') return;
+    fetch_metrics_t *m = claim_fetch_metrics(hash_url(url));
+    observe(&m->duration, fetch_bounds_us, duration_us);
+    atomic_fetch_add_explicit(&m->bytes, bytes, memory_order_relaxed);
+    if (!ok) atomic_fetch_add_explicit(&m->failures, 1, memory_order_relaxed);
+}
+
+void metrics_observe_wifi_reconnect(uint32_t duration_us, bool connected)
+{
+    if (!connected) {
+        atomic_fetch_add_explicit(&reconnect_failures, 1, memory_order_relaxed);
+        return;
+    }
+    observe(&reconnect_hist, reconnect_bounds_us, duration_us);
+}
+
+// ---- Rendering ----
+
+typedef struct {
+    char *buf;
+    size_t size;
+    size_t len;
+    metrics_flush_cb_t flush;
+    void *ctx;
+    bool failed;
+} out_t;
+
+static void out_flush(out_t *o)
+{
+    if (o->failed || o->len == 0) return;
+    if (!o->flush(o->ctx, o->buf, o->len)) o->failed = true;
+    o->len = 0;
+}
+
+static void out_printf(out_t *o, const char *fmt, ...)
+{
+    char line[160];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(line, sizeof(line), fmt, args);
+    va_end(args);
+    if (n < 0) return;
+    if ((size_t)n >= sizeof(line)) n = sizeof(line) - 1;
+
+    const char *p = line;
+    while (n > 0 && !o->failed) {
+        if (o->len == o->size) out_flush(o);
+        size_t room = o->size - o->len;
+        size_t chunk = (size_t)n < room ? (size_t)n : room;
+        memcpy(o->buf + o->len, p, chunk);
+        o->len += chunk;
+        p += chunk;
+        n -= chunk;
+    }
+}
+
+static void out_header(out_t *o, const char *name, const char *type, const char *help)
+{
+    out_printf(o, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+static void out_gauge(out_t *o, const char *name, const char *help, uint32_t value)
+{
+    out_header(o, name, "gauge", help);
+    out_printf(o, "%s %u\n", name, (unsigned)value);
+}
+
+static void out_counter(out_t *o, const char *name, const char *help, uint32_t value)
+{
+    out_header(o, name, "counter", help);
+    out_printf(o, "%s %u\n", name, (unsigned)value);
+}
+
+// Bucket, sum and count lines for one histogram; labels is "" or
+// `key="value"` pairs.
+static void out_histogram(out_t *o, const char *name, const char *labels,
+                          const histogram_t *h, const uint32_t *bounds_us)
+{
+    const char *sep = labels[0] ? "," : "";
+    uint32_t cumulative = 0;
+    for (int i = 0; i <= METRICS_MAX_BOUNDS; i++) {
+        cumulative += atomic_load_explicit(&h->buckets[i], memory_order_relaxed);
+        if (i < METRICS_MAX_BOUNDS) {
+            uint32_t us = bounds_us[i];
+            out_printf(o, "%s_bucket{%s%sle=\"%u.%06u\"} %u\n", name, labels, sep,
+                       (unsigned)(us / 1000000), (unsigned)(us % 1000000), (unsigned)cumulative);
+        } else {
+            out_printf(o, "%s_bucket{%s%sle=\"+Inf\"} %u\n", name, labels, sep,
+                       (unsigned)cumulative);
+        }
+    }
+
+    char braces[96] = "";
+    if (labels[0]) snprintf(braces, sizeof(braces), "{%s}", labels);
+    uint32_t sum_ms = atomic_load_explicit(&h->sum_ms, memory_order_relaxed);
+    out_printf(o, "%s_sum%s %u.%03u\n", name, braces,
+               (unsigned)(sum_ms / 1000), (unsigned)(sum_ms % 1000));
+    out_printf(o, "%s_count%s %u\n", name, braces,
+               (unsigned)atomic_load_explicit(&h->count, memory_order_relaxed));
+}
+
+// Label value with backslash, quote and newline escaped.
+static void escape_label(const char *in, char *out, size_t out_size)
+{
+    size_t n = 0;
+    for (; *in && n + 2 < out_size; in++) {
+        if (*in == '\\' || *in == '"') {
+            out[n++] = '\\';
+            out[n++] = *in;
+        } else if (*in == '\n') {
+            out[n++] = '\\';
+            out[n++] = 'n';
+        } else {
+            out[n++] = *in;
+        }
+    }
+    out[n] = '\0';
+}
+
+static void render_system(out_t *o)
+{
+    out_gauge(o, "mancave_uptime_seconds", "Time since boot.",
+              (uint32_t)(esp_timer_get_time() / 1000000));
+    out_gauge(o, "mancave_heap_free_bytes", "Free heap.", esp_get_free_heap_size());
+    out_gauge(o, "mancave_heap_min_free_bytes", "Lowest free heap since boot.",
+              esp_get_minimum_free_heap_size());
+    out_gauge(o, "mancave_heap_largest_free_block_bytes", "Largest allocatable block.",
+              heap_caps_get_largest_free_block(MALLOC_CAP_8BIT));
+
+    out_header(o, "mancave_task_stack_free_min_bytes", "gauge",
+               "Lowest unused stack seen for the task.");
+    for (size_t i = 0; i < sizeof(stack_tasks) / sizeof(stack_tasks[0]); i++) {
+        TaskHandle_t task = xTaskGetHandle(stack_tasks[i]);
+        if (!task) continue;
+        out_printf(o, "mancave_task_stack_free_min_bytes{task=\"%s\"} %u\n", stack_tasks[i],
+                   (unsigned)uxTaskGetStackHighWaterMark(task));
+    }
+}
+
+static void render_display(out_t *o)
+{
+    led_panel_stats_t ps;
+    led_panel_get_stats(&ps);
+    out_counter(o, "mancave_display_frames_total", "LED refreshes.", ps.refresh_count);
+    out_counter(o, "mancave_display_slow_refreshes_total",
+                "Refreshes that overran the LED wire time.", ps.slow_refreshes);
+    out_counter(o, "mancave_display_stalls_total",
+                "Gaps between refreshes over the stall threshold.", ps.stalls);
+
+    out_header(o, "mancave_frame_interval_seconds", "histogram", "Time between LED refreshes.");
+    out_histogram(o, "mancave_frame_interval_seconds", "", &frame_hist, frame_bounds_us);
+}
+
+static void render_feeds(out_t *o, const app_settings_t *s)
+{
+    int sources = s->rss_source_count < MAX_RSS_SOURCES ? s->rss_source_count : MAX_RSS_SOURCES;
+    char name[64];
+    char labels[80];
+
+    const fetch_metrics_t *found[MAX_RSS_SOURCES];
+    for (int i = 0; i < sources; i++) {
+        found[i] = find_fetch_metrics(hash_url(s->rss_sources[i].url));
+    }
+
+    out_header(o, "mancave_rss_fetch_duration_seconds", "histogram",
+               "Feed fetch time per source.");
+    for (int i = 0; i < sources; i++) {
+        escape_label(s->rss_sources[i].name, name, sizeof(name));
+        snprintf(labels, sizeof(labels), "source=\"%s\"", name);
+        out_histogram(o, "mancave_rss_fetch_duration_seconds", labels,
+                      found[i] ? &found[i]->duration : &empty_hist, fetch_bounds_us);
+    }
+
+    out_header(o, "mancave_rss_fetch_bytes_total", "counter", "Response bytes read per source.");
+    for (int i = 0; i < sources; i++) {
+        escape_label(s->rss_sources[i].name, name, sizeof(name));
+        unsigned bytes = found[i] ? atomic_load_explicit(&found[i]->bytes, memory_order_relaxed) : 0;
+        out_printf(o, "mancave_rss_fetch_bytes_total{source=\"%s\"} %u\n", name, bytes);
+    }
+
+    out_header(o, "mancave_rss_fetch_failures_total", "counter", "Failed fetches per source.");
+    for (int i = 0; i < sources; i++) {
+        escape_label(s->rss_sources[i].name, name, sizeof(name));
+        unsigned failures =
+            found[i] ? atomic_load_explicit(&found[i]->failures, memory_order_relaxed) : 0;
+        out_printf(o, "mancave_rss_fetch_failures_total{source=\"%s\"} %u\n", name, failures);
+    }
+
+    out_header(o, "mancave_rss_cache_lookups_total", "counter", "Feed cache item picks and availability checks.");
+    out_printf(o, "mancave_rss_cache_lookups_total{result=\"hit\"} %u\n",
+               (unsigned)atomic_load_explicit(&counters[METRIC_RSS_CACHE_HITS], memory_order_relaxed));
+    out_printf(o, "mancave_rss_cache_lookups_total{result=\"miss\"} %u\n",
+               (unsigned)atomic_load_explicit(&counters[METRIC_RSS_CACHE_MISSES], memory_order_relaxed));
+}
+
+static void render_storage(out_t *o)
+{
+    out_counter(o, "mancave_nvs_write_bytes_total", "Bytes written to NVS.",
+                atomic_load_explicit(&counters[METRIC_NVS_WRITE_BYTES], memory_order_relaxed));
+    out_counter(o, "mancave_littlefs_write_bytes_total", "Bytes written to LittleFS.",
+                atomic_load_explicit(&counters[METRIC_LITTLEFS_WRITE_BYTES], memory_order_relaxed));
+}
+
+static void render_wifi(out_t *o)
+{
+    out_header(o, "mancave_wifi_reconnect_seconds", "histogram",
+               "Time from radio on to connected.");
+    out_histogram(o, "mancave_wifi_reconnect_seconds", "", &reconnect_hist, reconnect_bounds_us);
+    out_counter(o, "mancave_wifi_reconnect_failures_total", "Radio-on attempts that failed.",
+                atomic_load_explicit(&reconnect_failures, memory_order_relaxed));
+}
+
+bool metrics_render(const app_settings_t *s, char *buf, size_t size,
+                    metrics_flush_cb_t flush, void *ctx)
+{
+    out_t o = {.buf = buf, .size = size, .flush = flush, .ctx = ctx};
+    if (!buf || size == 0 || !flush) return false;
+
+    render_system(&o);
+    render_display(&o);
+    if (s) render_feeds(&o, s);
+    render_storage(&o);
+    render_wifi(&o);
+    out_flush(&o);
+    return !o.failed;
+}
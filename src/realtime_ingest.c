@@ -0,0 +1,208 @@
+#include "realtime_ingest.h"
+#include <string.h>
+#include <stdatomic.h>
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "lwip/sockets.h"
+
+static const char *TAG = "realtime";
+
+#define REALTIME_TASK_CORE    0
+#define REALTIME_MAX_PACKET   1472  // UDP payload of a 1500-byte MTU frame
+#define REALTIME_RECV_POLL_MS 250   // how often the task checks for stop
+
+// Triple buffer: the ingest task fills `back`, publishes it by swapping it
+// with `ready`, and the display loop swaps `ready` with `front`. Neither
+// side waits for the other; an unread frame is simply replaced.
+#define BUF_INDEX_MASK 0x3
+#define BUF_FRESH      0x4
+
+static uint8_t buffers[3][REALTIME_INGEST_FRAME_BYTES];
+static int back = 0;                 // ingest task
+static int last_published = 1;       // ingest task
+static atomic_int ready = 1;         // shared
+static int front = 2;                // display loop
+static SemaphoreHandle_t frame_sem = NULL;
+
+static TaskHandle_t ingest_task = NULL;
+static volatile bool running = false;
+static volatile bool have_packets = false;
+static volatile TickType_t last_packet_tick = 0;
+
+static uint8_t last_seq = 0;
+static bool frame_torn = false;
+static realtime_ingest_stats_t stats;
+
+static void publish_frame(void)
+{
+    int old = atomic_exchange(&ready, back | BUF_FRESH);
+    if (old & BUF_FRESH) stats.frames_skipped++;
+    stats.frames++;
+
+    last_published = back;
+    back = old & BUF_INDEX_MASK;
+    // Column strips update part of a frame; start the next one from this.
+    memcpy(buffers[back], buffers[last_published], REALTIME_INGEST_FRAME_BYTES);
+    xSemaphoreGive(frame_sem);
+}
+
+// DDP sequence numbers run 1..15. Returns false for a duplicate or
+// out-of-order packet; marks the frame torn when packets were skipped.
+static bool accept_sequence(uint8_t seq)
+{
+    if (seq == 0) return true;
+    if (last_seq != 0) {
+        int step = (seq - last_seq + 15) % 15;
+        if (step == 0 || step >= 8) return false;
+        if (step > 1) frame_torn = true;
+    }
+    last_seq = seq;
+    return true;
+}
+
+static void handle_packet(const uint8_t *p, int len)
+{
+    if (len < DDP_HEADER_LEN ||
+        (p[0] & DDP_FLAG_VER_MASK) != DDP_FLAG_VER1 ||
+        (p[0] & (DDP_FLAG_QUERY | DDP_FLAG_REPLY | DDP_FLAG_STORAGE)) ||
+        p[3] != DDP_ID_DISPLAY) {
+        stats.packets_invalid++;
+        return;
+    }
+
+    int header = DDP_HEADER_LEN + ((p[0] & DDP_FLAG_TIMECODE) ? DDP_TIMECODE_LEN : 0);
+    uint32_t offset = ((uint32_t)p[4] << 24) | ((uint32_t)p[5] << 16) |
+                      ((uint32_t)p[6] << 8) | p[7];
+    int data_len = (p[8] << 8) | p[9];
+    if (header + data_len > len) {
+        stats.packets_invalid++;
+        return;
+    }
+
+    TickType_t now = xTaskGetTickCount();
+    if (have_packets && (now - last_packet_tick) >= pdMS_TO_TICKS(REALTIME_INGEST_TIMEOUT_MS)) {
+        // A new session; don't judge its sequence against the old one.
+        last_seq = 0;
+        frame_torn = false;
+    }
+    if (!accept_sequence(p[1] & DDP_SEQ_MASK)) {
+        stats.packets_late++;
+        return;
+    }
+
+    stats.packets++;
+    last_packet_tick = now;
+    have_packets = true;
+
+    if (offset < REALTIME_INGEST_FRAME_BYTES) {
+        uint32_t room = REALTIME_INGEST_FRAME_BYTES - offset;
+        memcpy(buffers[back] + offset, p + header, (uint32_t)data_len < room ? (uint32_t)data_len : room);
+    }
+
+    if (p[0] & DDP_FLAG_PUSH) {
+        if (frame_torn) {
+            // Showing half of two frames is worse than repeating one.
+            stats.frames_torn++;
+            memcpy(buffers[back], buffers[last_published], REALTIME_INGEST_FRAME_BYTES);
+            frame_torn = false;
+        } else {
+            publish_frame();
+        }
+    }
+}
+
+static void realtime_ingest_task(void *arg)
+{
+    (void)arg;
+    static uint8_t packet[REALTIME_MAX_PACKET];
+
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock < 0) {
+        ESP_LOGE(TAG, "Failed to create socket");
+        goto done;
+    }
+
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(REALTIME_INGEST_PORT),
+        .sin_addr.s_addr = htonl(INADDR_ANY),
+    };
+    if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        ESP_LOGE(TAG, "Failed to bind UDP port %d", REALTIME_INGEST_PORT);
+        close(sock);
+        goto done;
+    }
+
+    struct timeval tv = {.tv_sec = 0, .tv_usec = REALTIME_RECV_POLL_MS * 1000};
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    ESP_LOGI(TAG, "Listening for DDP on UDP %d", REALTIME_INGEST_PORT);
+
+    while (running) {
+        int len = recv(sock, packet, sizeof(packet), 0);
+        if (len > 0) handle_packet(packet, len);
+    }
+    close(sock);
+
+done:
+    have_packets = false;
+    ingest_task = NULL;
+    vTaskDelete(NULL);
+}
+
+esp_err_t realtime_ingest_start(void)
+{
+    if (ingest_task) return ESP_OK;
+
+    if (!frame_sem) {
+        frame_sem = xSemaphoreCreateBinary();
+        if (!frame_sem) return ESP_ERR_NO_MEM;
+    }
+
+    last_seq = 0;
+    frame_torn = false;
+    running = true;
+    // Next to lwIP on core 0, above the preview and feed tasks so bursts
+    // of packets are drained before the socket buffer overflows.
+    if (xTaskCreatePinnedToCore(realtime_ingest_task, "realtime_ingest", 3072, NULL, 5,
+                                &ingest_task, REALTIME_TASK_CORE) != pdPASS) {
+        running = false;
+        ingest_task = NULL;
+        ESP_LOGE(TAG, "Failed to start ingest task");
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+void realtime_ingest_stop(void)
+{
+    if (!ingest_task) return;
+    running = false;
+    // The task sees the flag within one receive timeout.
+    for (int i = 0; i < 4 && ingest_task; i++) {
+        vTaskDelay(pdMS_TO_TICKS(REALTIME_RECV_POLL_MS / 2));
+    }
+    have_packets = false;
+}
+
+bool realtime_ingest_active(void)
+{
+    return have_packets &&
+           (xTaskGetTickCount() - last_packet_tick) < pdMS_TO_TICKS(REALTIME_INGEST_TIMEOUT_MS);
+}
+
+bool realtime_ingest_wait_frame(const uint8_t **rgb, TickType_t wait)
+{
+    if (!frame_sem || xSemaphoreTake(frame_sem, wait) != pdTRUE) return false;
+    if (!(atomic_load(&ready) & BUF_FRESH)) return false;
+
+    front = atomic_exchange(&ready, front) & BUF_INDEX_MASK;
+    *rgb = buffers[front];
+    return true;
+}
+
+void realtime_ingest_get_stats(realtime_ingest_stats_t *out)
+{
+    if (!out) return;
+    *out = stats;
+}
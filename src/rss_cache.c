@@ -1,5 +1,7 @@
 #include "rss_cache.h"
 #include "storage_paths.h"
+#include "metrics.h"
+#include "trace.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -9,6 +11,8 @@
 #include <sys/stat.h>
 #include <errno.h>
 #include <ctype.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "esp_log.h"
 #include "esp_random.h"
 
@@ -16,8 +20,12 @@ static const char *TAG = "rss_cache";
 
 #define RSS_CACHE_DIR LITTLEFS_BASE_PATH "/cache"
 #define RSS_CACHE_MAGIC 0x52434348u  // "RCCH"
-#define RSS_CACHE_VERSION 1u
+#define RSS_CACHE_VERSION 2u
 #define RSS_CACHE_MAX_SOURCES 16
+// A cache file never holds more items than one fetch returns; headers
+// claiming more are clamped, so the shown-item bitmaps are fixed size.
+#define RSS_CACHE_MAX_ITEMS   RSS_MAX_ITEMS
+#define CYCLE_BITMAP_BYTES    ((RSS_CACHE_MAX_ITEMS + 7) / 8)
 
 typedef struct {
     uint32_t magic;
@@ -25,17 +33,23 @@ typedef struct {
     uint16_t reserved;
     uint32_t item_count;
     uint32_t updated_epoch;
+    uint32_t content_hash;  // mix of all item hashes, changes when any item does
+    uint16_t live_count;
+    uint16_t reserved2;
 } rss_cache_header_t;
 
 typedef struct {
     char title[RSS_TITLE_LEN + 1];
     char description[RSS_DESC_LEN + 1];
+    uint8_t flags;  // RSS_CACHE_ITEM_FLAG_*, resolved when the item is stored
+    uint8_t reserved;
+    uint32_t hash;
 } rss_cache_record_t;
 
 typedef struct {
     uint32_t item_count;
     uint32_t shown_count;
-    uint8_t *shown_bits;
+    uint8_t shown_bits[CYCLE_BITMAP_BYTES];
 } cycle_source_state_t;
 
 typedef struct {
@@ -49,6 +63,10 @@ typedef struct {
 
 static cycle_state_t g_cycle_state = {0};
 
+// Guards the cache files and g_cycle_state: a background refresh may store a
+// source while the display task picks the next item.
+static SemaphoreHandle_t cache_mutex = NULL;
+
 static uint32_t hash_url(const char *s)
 {
     uint32_t hash = 2166136261u;
@@ -89,8 +107,10 @@ static bool read_cache_header(const char *source_url, rss_cache_header_t *out_he
     rss_cache_header_t header = {0};
     size_t n = fread(&header, 1, sizeof(header), fp);
     fclose(fp);
-    if (n != sizeof(header)) return false;
-    if (header.magic != RSS_CACHE_MAGIC || header.version != RSS_CACHE_VERSION) return false;
+    if (n != sizeof(header) ||
+        header.magic != RSS_CACHE_MAGIC || header.version != RSS_CACHE_VERSION) {
+        return false;
+    }
 
     if (out_header) {
         *out_header = header;
@@ -98,11 +118,10 @@ static bool read_cache_header(const char *source_url, rss_cache_header_t *out_he
     return true;
 }
 
-static void cycle_state_free(void)
+static void cycle_state_clear(void)
 {
     for (int i = 0; i < RSS_CACHE_MAX_SOURCES; i++) {
-        free(g_cycle_state.sources[i].shown_bits);
-        g_cycle_state.sources[i].shown_bits = NULL;
+        memset(g_cycle_state.sources[i].shown_bits, 0, CYCLE_BITMAP_BYTES);
         g_cycle_state.sources[i].item_count = 0;
         g_cycle_state.sources[i].shown_count = 0;
     }
@@ -115,13 +134,11 @@ static void cycle_state_free(void)
 
 static bool bit_get(const uint8_t *bits, uint32_t index)
 {
-    if (!bits) return false;
     return (bits[index / 8] & (1u << (index % 8))) != 0;
 }
 
 static void bit_set(uint8_t *bits, uint32_t index)
 {
-    if (!bits) return;
     bits[index / 8] |= (1u << (index % 8));
 }
 
@@ -175,7 +192,7 @@ static esp_err_t cycle_state_ensure(const char *const *source_urls, int source_u
         return ESP_OK;
     }
 
-    cycle_state_free();
+    cycle_state_clear();
 
     g_cycle_state.signature = signature;
     g_cycle_state.source_count = source_url_count;
@@ -187,17 +204,11 @@ static esp_err_t cycle_state_ensure(const char *const *source_urls, int source_u
             continue;
         }
 
-        g_cycle_state.sources[i].item_count = headers[i].item_count;
+        uint32_t item_count = headers[i].item_count;
+        if (item_count > RSS_CACHE_MAX_ITEMS) item_count = RSS_CACHE_MAX_ITEMS;
+        g_cycle_state.sources[i].item_count = item_count;
         g_cycle_state.sources[i].shown_count = 0;
-
-        size_t bit_bytes = (size_t)((headers[i].item_count + 7u) / 8u);
-        g_cycle_state.sources[i].shown_bits = calloc(1, bit_bytes);
-        if (!g_cycle_state.sources[i].shown_bits) {
-            cycle_state_free();
-            return ESP_ERR_NO_MEM;
-        }
-
-        g_cycle_state.total_items += headers[i].item_count;
+        g_cycle_state.total_items += item_count;
     }
 
     g_cycle_state.remaining_items = g_cycle_state.total_items;
@@ -211,9 +222,8 @@ static void cycle_state_restart(void)
 
     for (int i = 0; i < g_cycle_state.source_count; i++) {
         cycle_source_state_t *src = &g_cycle_state.sources[i];
-        if (!src->shown_bits || src->item_count == 0) continue;
-        size_t bit_bytes = (size_t)((src->item_count + 7u) / 8u);
-        memset(src->shown_bits, 0, bit_bytes);
+        if (src->item_count == 0) continue;
+        memset(src->shown_bits, 0, sizeof(src->shown_bits));
         src->shown_count = 0;
     }
 
@@ -243,6 +253,11 @@ static uint8_t infer_item_flags(const rss_item_t *item)
 {
     if (!item) return 0;
 
+    // Scroller-feed items arrive already classified by the server.
+    if (item->flags & RSS_ITEM_FLAG_CLASSIFIED) {
+        return (item->flags & RSS_ITEM_FLAG_LIVE) ? RSS_CACHE_ITEM_FLAG_LIVE : 0;
+    }
+
     // End-state markers take precedence over live markers.
     static const char *finished_markers[] = {
         " final",
@@ -328,21 +343,32 @@ static esp_err_t read_cache_record(const char *source_url, uint32_t item_index,
     return ESP_OK;
 }
 
+// False until rss_cache_init() has created the mutex; callers then behave
+// as if nothing were cached.
+static bool cache_lock(void)
+{
+    if (!cache_mutex) return false;
+    xSemaphoreTake(cache_mutex, portMAX_DELAY);
+    return true;
+}
+
 esp_err_t rss_cache_init(void)
 {
+    if (!cache_mutex) {
+        cache_mutex = xSemaphoreCreateMutex();
+        if (!cache_mutex) return ESP_ERR_NO_MEM;
+    }
     int rc = mkdir(RSS_CACHE_DIR, 0775);
     if (rc != 0 && errno != EEXIST) {
         ESP_LOGE(TAG, "Failed to create cache dir (%s): errno=%d", RSS_CACHE_DIR, errno);
         return ESP_FAIL;
     }
-    cycle_state_free();
+    cycle_state_clear();
     return ESP_OK;
 }
 
-esp_err_t rss_cache_store_from_fetcher(const char *source_url, const char *source_name)
+static esp_err_t store_from_fetcher(const char *source_url, const char *source_name)
 {
-    if (!source_url || source_url[0] == '\0') return ESP_ERR_INVALID_ARG;
-
     int item_count = rss_get_count();
     if (item_count <= 0) {
         // Keep previous cache if feed is empty this cycle.
@@ -366,13 +392,26 @@ esp_err_t rss_cache_store_from_fetcher(const char *source_url, const char *sourc
         .reserved = 0,
         .item_count = (uint32_t)item_count,
         .updated_epoch = (uint32_t)time(NULL),
+        .content_hash = 2166136261u,
+        .live_count = 0,
+        .reserved2 = 0,
     };
 
+    for (int i = 0; i < item_count; i++) {
+        const rss_item_t *src = rss_get_item(i);
+        if (!src) continue;
+        header.content_hash = hash_mix_u32(header.content_hash, src->hash);
+        if (infer_item_flags(src) & RSS_CACHE_ITEM_FLAG_LIVE) {
+            header.live_count++;
+        }
+    }
+
     if (fwrite(&header, 1, sizeof(header), fp) != sizeof(header)) {
         fclose(fp);
         remove(temp_path);
         return ESP_FAIL;
     }
+    uint32_t written = sizeof(header);
 
     for (int i = 0; i < item_count; i++) {
         const rss_item_t *src = rss_get_item(i);
@@ -384,12 +423,15 @@ esp_err_t rss_cache_store_from_fetcher(const char *source_url, const char *sourc
         rec.title[RSS_TITLE_LEN] = '\0';
         strncpy(rec.description, src->description, RSS_DESC_LEN);
         rec.description[RSS_DESC_LEN] = '\0';
+        rec.flags = infer_item_flags(src);
+        rec.hash = src->hash;
 
         if (fwrite(&rec, 1, sizeof(rec), fp) != sizeof(rec)) {
             fclose(fp);
             remove(temp_path);
             return ESP_FAIL;
         }
+        written += sizeof(rec);
     }
 
     fclose(fp);
@@ -404,38 +446,65 @@ esp_err_t rss_cache_store_from_fetcher(const char *source_url, const char *sourc
         }
     }
 
+    metrics_add(METRIC_LITTLEFS_WRITE_BYTES, written);
+
     // Cache content changed; rebuild no-repeat state on next pick.
     g_cycle_state.valid = false;
 
-    ESP_LOGI(TAG, "Cached %d items for source '%s'", item_count, source_name ? source_name : source_url);
+    ESP_LOGI(TAG, "Cached %d items (%u live) for source '%s'", item_count,
+             (unsigned)header.live_count, source_name ? source_name : source_url);
     return ESP_OK;
 }
 
+esp_err_t rss_cache_store_from_fetcher(const char *source_url, const char *source_name)
+{
+    if (!source_url || source_url[0] == '\0') return ESP_ERR_INVALID_ARG;
+
+    trace_begin(TRACE_CAT_REFRESH, "cache_store", rss_get_count());
+    esp_err_t err = ESP_ERR_INVALID_STATE;
+    if (cache_lock()) {
+        err = store_from_fetcher(source_url, source_name);
+        xSemaphoreGive(cache_mutex);
+    }
+    trace_end(TRACE_CAT_REFRESH, "cache_store", err);
+    return err;
+}
+
 bool rss_cache_has_items_for_url(const char *source_url)
 {
     rss_cache_header_t header = {0};
-    if (!read_cache_header(source_url, &header)) return false;
-    return header.item_count > 0;
+    if (!cache_lock()) return false;
+    bool found = read_cache_header(source_url, &header);
+    xSemaphoreGive(cache_mutex);
+    found = found && header.item_count > 0;
+    metrics_add(found ? METRIC_RSS_CACHE_HITS : METRIC_RSS_CACHE_MISSES, 1);
+    return found;
 }
 
-esp_err_t rss_cache_pick_random_item_ex(const char *const *source_urls,
-                                        int source_url_count,
-                                        rss_item_t *out_item,
-                                        int *out_source_index,
-                                        uint8_t *out_flags,
-                                        bool *out_cycle_reset)
+esp_err_t rss_cache_get_source_info(const char *source_url, rss_cache_source_info_t *out_info)
 {
-    if (!source_urls || source_url_count <= 0 || !out_item) {
-        return ESP_ERR_INVALID_ARG;
-    }
+    if (!source_url || !out_info) return ESP_ERR_INVALID_ARG;
 
-    if (source_url_count > RSS_CACHE_MAX_SOURCES) {
-        source_url_count = RSS_CACHE_MAX_SOURCES;
-    }
-
-    if (out_cycle_reset) *out_cycle_reset = false;
-    if (out_flags) *out_flags = 0;
+    rss_cache_header_t header = {0};
+    if (!cache_lock()) return ESP_ERR_INVALID_STATE;
+    bool found = read_cache_header(source_url, &header);
+    xSemaphoreGive(cache_mutex);
+    if (!found) return ESP_ERR_NOT_FOUND;
+
+    out_info->item_count = header.item_count;
+    out_info->updated_epoch = header.updated_epoch;
+    out_info->content_hash = header.content_hash;
+    out_info->live_count = header.live_count;
+    return ESP_OK;
+}
 
+static esp_err_t pick_random_item(const char *const *source_urls,
+                                  int source_url_count,
+                                  rss_item_t *out_item,
+                                  int *out_source_index,
+                                  uint8_t *out_flags,
+                                  bool *out_cycle_reset)
+{
     esp_err_t state_err = cycle_state_ensure(source_urls, source_url_count);
     if (state_err != ESP_OK) {
         return state_err;
@@ -503,16 +572,44 @@ esp_err_t rss_cache_pick_random_item_ex(const char *const *source_urls,
     out_item->title[RSS_TITLE_LEN] = '\0';
     strncpy(out_item->description, rec.description, RSS_DESC_LEN);
     out_item->description[RSS_DESC_LEN] = '\0';
+    out_item->flags = rec.flags;
+    out_item->hash = rec.hash;
 
     if (out_source_index) {
         *out_source_index = selected_source;
     }
     if (out_flags) {
-        *out_flags = infer_item_flags(out_item);
+        *out_flags = rec.flags;
     }
     return ESP_OK;
 }
 
+esp_err_t rss_cache_pick_random_item_ex(const char *const *source_urls,
+                                        int source_url_count,
+                                        rss_item_t *out_item,
+                                        int *out_source_index,
+                                        uint8_t *out_flags,
+                                        bool *out_cycle_reset)
+{
+    if (!source_urls || source_url_count <= 0 || !out_item) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (source_url_count > RSS_CACHE_MAX_SOURCES) {
+        source_url_count = RSS_CACHE_MAX_SOURCES;
+    }
+
+    if (out_cycle_reset) *out_cycle_reset = false;
+    if (out_flags) *out_flags = 0;
+
+    if (!cache_lock()) return ESP_ERR_INVALID_STATE;
+    esp_err_t err = pick_random_item(source_urls, source_url_count, out_item,
+                                     out_source_index, out_flags, out_cycle_reset);
+    xSemaphoreGive(cache_mutex);
+    metrics_add(err == ESP_OK ? METRIC_RSS_CACHE_HITS : METRIC_RSS_CACHE_MISSES, 1);
+    return err;
+}
+
 esp_err_t rss_cache_pick_random_item(const char *const *source_urls,
                                      int source_url_count,
                                      rss_item_t *out_item,
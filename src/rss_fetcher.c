@@ -5,11 +5,16 @@
 #include "esp_http_client.h"
 #include "esp_crt_bundle.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "json_stream.h"
+#include "trace.h"
+#include "arena.h"
 
 static const char *TAG = "rss_fetcher";
 
 static rss_item_t rss_items[RSS_MAX_ITEMS];
 static int rss_count = 0;
+static int last_fetch_bytes = 0;
 
 // ── HTML entity decoding ──
 
@@ -245,110 +250,394 @@ static void extract_and_clean(const char *content, int content_len,
     sanitize_to_ascii(buf);
 }
 
+// ── Item hashing ──
+
+static uint32_t hash_item_text(const rss_item_t *item)
+{
+    uint32_t hash = 2166136261u;
+    for (const char *p = item->title; *p; p++) {
+        hash ^= (uint8_t)*p;
+        hash *= 16777619u;
+    }
+    hash ^= 0x1Fu;
+    hash *= 16777619u;
+    for (const char *p = item->description; *p; p++) {
+        hash ^= (uint8_t)*p;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
 // ── RSS XML parser ──
 
-static void parse_rss_xml(const char *xml, int xml_len)
+// Parse one <item> block; item_end points at its closing </item> tag.
+static void parse_rss_item(const char *item_start, const char *item_end)
 {
-    rss_count = 0;
-    const char *pos = xml;
-    const char *xml_end = xml + xml_len;
-
-    while (pos < xml_end && rss_count < RSS_MAX_ITEMS) {
-        // Find next <item>
-        const char *item_start = strstr(pos, "<item>");
-        if (!item_start) break;
-
-        const char *item_end = strstr(item_start, "</item>");
-        if (!item_end) break;
-
-        // Search within this item only
-        const char *item_pos = item_start;
-        int len;
-
-        // Extract title
-        const char *title = extract_tag(xml, &item_pos, "<title>", "</title>", &len);
-        if (title && item_pos <= item_end) {
-            extract_and_clean(title, len,
-                              rss_items[rss_count].title, RSS_TITLE_LEN + 1);
-        } else {
-            rss_items[rss_count].title[0] = '\0';
+    // Search within this item only
+    const char *item_pos = item_start;
+    int len;
+
+    // Extract title
+    const char *title = extract_tag(item_start, &item_pos, "<title>", "</title>", &len);
+    if (title && item_pos <= item_end) {
+        extract_and_clean(title, len,
+                          rss_items[rss_count].title, RSS_TITLE_LEN + 1);
+    } else {
+        rss_items[rss_count].title[0] = '\0';
+    }
+
+    // Extract description
+    item_pos = item_start;  // reset to search from item start
+    const char *desc = extract_tag(item_start, &item_pos, "<description>", "</description>", &len);
+    if (desc && item_pos <= item_end + 13) {  // +13 for </description> tag length
+        extract_and_clean(desc, len,
+                          rss_items[rss_count].description, RSS_DESC_LEN + 1);
+    } else {
+        rss_items[rss_count].description[0] = '\0';
+    }
+
+    // Only count items that have at least a title
+    if (rss_items[rss_count].title[0] != '\0') {
+        rss_items[rss_count].flags = 0;
+        rss_items[rss_count].hash = hash_item_text(&rss_items[rss_count]);
+        rss_count++;
+    }
+}
+
+// ── Streaming item scanner ──
+
+// Response bytes are read into a small window and each <item> is parsed as soon
+// as its closing tag arrives, so the download can stop once RSS_MAX_ITEMS are in.
+#define RSS_STREAM_WINDOW_SIZE (8 * 1024)
+#define RSS_MAX_REDIRECTS      3
+
+// Binary scroller feed (see README): "MCSF", version, flags, u16 item count,
+// then per item: flags, title_len, desc_len, reserved, u32 hash, title, desc.
+// Text is pre-sanitized ASCII, so items skip the XML cleanup passes entirely.
+#define SCROLLER_FEED_MAGIC      "MCSF"
+#define SCROLLER_FEED_MAGIC_LEN  4
+#define SCROLLER_FEED_VERSION    1
+#define SCROLLER_FEED_HEADER_LEN 8
+#define SCROLLER_FEED_RECORD_LEN 8
+#define SCROLLER_FEED_ACCEPT     "application/x-scroller-feed, application/rss+xml;q=0.9, */*;q=0.8"
+
+typedef enum {
+    FEED_FORMAT_UNKNOWN,
+    FEED_FORMAT_RSS,
+    FEED_FORMAT_SCROLLER,
+    FEED_FORMAT_JSON,
+} feed_format_t;
+
+// JSON feeds map two field paths onto title/description. Paths are split at
+// the last "[]" into the item array path and a field relative to each item.
+typedef struct {
+    json_stream_t parser;
+    char item_path[JSON_STREAM_MAX_PATH + 1];
+    const char *title_field;
+    const char *desc_field;
+    bool in_item;
+} json_feed_t;
+
+typedef struct {
+    char *window;
+    int window_len;
+    feed_format_t format;
+    json_feed_t *json;
+    bool header_done;
+    uint32_t items_remaining;
+    bool complete;
+    esp_err_t error;
+} rss_stream_t;
+
+// The read window and JSON parser come from a static arena that is reset
+// when the fetch ends, so a refresh takes nothing from the heap itself and
+// cannot leave holes in it.
+#define RSS_FETCH_ARENA_SIZE (RSS_STREAM_WINDOW_SIZE + sizeof(json_feed_t) + 2 * ARENA_ALIGN)
+
+static uint8_t fetch_arena_buf[RSS_FETCH_ARENA_SIZE];
+static arena_t fetch_arena;
+
+static void stream_discard(rss_stream_t *stream, int count)
+{
+    if (count <= 0) return;
+    if (count >= stream->window_len) {
+        stream->window_len = 0;
+    } else {
+        memmove(stream->window, stream->window + count, stream->window_len - count);
+        stream->window_len -= count;
+    }
+    stream->window[stream->window_len] = '\0';
+}
+
+// Parse every complete item in the window, keeping only the unconsumed tail.
+static void stream_scan_items(rss_stream_t *stream)
+{
+    static const char item_open[] = "<item>";
+    static const char item_close[] = "</item>";
+    const int open_len = (int)sizeof(item_open) - 1;
+    const int close_len = (int)sizeof(item_close) - 1;
+
+    while (rss_count < RSS_MAX_ITEMS) {
+        const char *item_start = strstr(stream->window, item_open);
+        if (!item_start) {
+            // Keep a short tail in case "<item>" is split across reads.
+            stream_discard(stream, stream->window_len - (open_len - 1));
+            return;
         }
 
-        // Extract description
-        item_pos = item_start;  // reset to search from item start
-        const char *desc = extract_tag(xml, &item_pos, "<description>", "</description>", &len);
-        if (desc && item_pos <= item_end + 13) {  // +13 for </description> tag length
-            extract_and_clean(desc, len,
-                              rss_items[rss_count].description, RSS_DESC_LEN + 1);
-        } else {
-            rss_items[rss_count].description[0] = '\0';
+        const char *item_end = strstr(item_start + open_len, item_close);
+        if (!item_end) {
+            // Incomplete item: move it to the front and wait for more data.
+            stream_discard(stream, (int)(item_start - stream->window));
+            return;
+        }
+
+        parse_rss_item(item_start, item_end);
+        stream_discard(stream, (int)(item_end + close_len - stream->window));
+    }
+}
+
+static uint16_t read_le16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t read_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Copy pre-sanitized feed text, replacing anything outside printable ASCII.
+static void copy_feed_text(char *dst, int dst_size, const uint8_t *src, int src_len)
+{
+    int len = (src_len < dst_size - 1) ? src_len : dst_size - 1;
+    for (int i = 0; i < len; i++) {
+        dst[i] = (src[i] >= 32 && src[i] <= 126) ? (char)src[i] : '?';
+    }
+    dst[len] = '\0';
+}
+
+// Decode every complete scroller-feed record in the window straight into rss_items.
+// A body that ends before the header's item count is reached is an error, so
+// a cut-off transfer never replaces a good cache.
+static void stream_decode_scroller(rss_stream_t *stream, bool at_eof)
+{
+    const uint8_t *buf = (const uint8_t *)stream->window;
+
+    if (!stream->header_done && stream->window_len >= SCROLLER_FEED_HEADER_LEN) {
+        if (buf[4] != SCROLLER_FEED_VERSION) {
+            ESP_LOGE(TAG, "Unsupported scroller feed version %u", buf[4]);
+            stream->error = ESP_ERR_INVALID_VERSION;
+            return;
         }
+        stream->items_remaining = read_le16(buf + 6);
+        stream->header_done = true;
+        stream_discard(stream, SCROLLER_FEED_HEADER_LEN);
+    }
 
-        // Only count items that have at least a title
-        if (rss_items[rss_count].title[0] != '\0') {
+    while (stream->header_done && rss_count < RSS_MAX_ITEMS && stream->items_remaining > 0) {
+        if (stream->window_len < SCROLLER_FEED_RECORD_LEN) break;
+
+        int title_len = buf[1];
+        int desc_len = buf[2];
+        int record_len = SCROLLER_FEED_RECORD_LEN + title_len + desc_len;
+        if (stream->window_len < record_len) break;
+
+        rss_item_t *item = &rss_items[rss_count];
+        copy_feed_text(item->title, RSS_TITLE_LEN + 1,
+                       buf + SCROLLER_FEED_RECORD_LEN, title_len);
+        copy_feed_text(item->description, RSS_DESC_LEN + 1,
+                       buf + SCROLLER_FEED_RECORD_LEN + title_len, desc_len);
+        item->flags = (buf[0] & (RSS_ITEM_FLAG_LIVE | RSS_ITEM_FLAG_FINAL)) |
+                      RSS_ITEM_FLAG_CLASSIFIED;
+        item->hash = read_le32(buf + 4);
+        if (item->title[0] != '\0') {
             rss_count++;
         }
 
-        pos = item_end + 7;  // past </item>
+        stream->items_remaining--;
+        stream_discard(stream, record_len);
     }
 
-    ESP_LOGI(TAG, "Parsed %d RSS items", rss_count);
+    if (stream->header_done && stream->items_remaining == 0) {
+        stream->complete = true;
+    } else if (at_eof && rss_count < RSS_MAX_ITEMS) {
+        if (stream->header_done) {
+            ESP_LOGE(TAG, "Scroller feed truncated: %u items missing",
+                     (unsigned)stream->items_remaining);
+        } else {
+            ESP_LOGE(TAG, "Scroller feed truncated before its header");
+        }
+        stream->error = ESP_ERR_INVALID_SIZE;
+    }
 }
 
-// ── HTTP client event handler ──
+// Split "events[].name" into item path "events[]" and field "name".
+static bool json_split_path(const char *path, char *item_path, size_t item_path_size,
+                            const char **field)
+{
+    if (!path) return false;
+    const char *marker = NULL;
+    for (const char *p = strstr(path, "[]"); p; p = strstr(p + 2, "[]")) {
+        marker = p;
+    }
+    if (!marker || marker[2] != '.' || marker[3] == '\0') return false;
+
+    size_t len = (size_t)(marker + 2 - path);
+    if (len >= item_path_size) return false;
+    memcpy(item_path, path, len);
+    item_path[len] = '\0';
+    *field = marker + 3;
+    return true;
+}
 
-typedef struct {
-    char *buffer;
-    int buffer_len;
-    int buffer_size;
-} http_response_t;
+static bool json_field_matches(const json_feed_t *feed, const char *path, const char *field)
+{
+    size_t len = strlen(feed->item_path);
+    return field && strncmp(path, feed->item_path, len) == 0 &&
+           path[len] == '.' && strcmp(path + len + 1, field) == 0;
+}
 
-static esp_err_t http_event_handler(esp_http_client_event_t *evt)
+static void json_copy_text(char *dst, int dst_size, const char *value, int value_len)
 {
-    http_response_t *resp = (http_response_t *)evt->user_data;
+    int len = (value_len < dst_size - 1) ? value_len : dst_size - 1;
+    memcpy(dst, value, len);
+    dst[len] = '\0';
+    decode_html_entities(dst);
+    sanitize_to_ascii(dst);
+}
 
-    switch (evt->event_id) {
-    case HTTP_EVENT_ON_DATA:
-        if (resp->buffer && (resp->buffer_len + evt->data_len < resp->buffer_size)) {
-            memcpy(resp->buffer + resp->buffer_len, evt->data, evt->data_len);
-            resp->buffer_len += evt->data_len;
+// Items are built in place in rss_items[rss_count] and kept when the object closes.
+static bool json_feed_event(void *ctx, json_stream_event_t event,
+                            const char *path, const char *value, int value_len)
+{
+    json_feed_t *feed = (json_feed_t *)ctx;
+    rss_item_t *item = &rss_items[rss_count];
+
+    switch (event) {
+    case JSON_STREAM_OBJECT_START:
+        if (strcmp(path, feed->item_path) == 0) {
+            memset(item, 0, sizeof(*item));
+            feed->in_item = true;
+        }
+        break;
+    case JSON_STREAM_OBJECT_END:
+        if (feed->in_item && strcmp(path, feed->item_path) == 0) {
+            feed->in_item = false;
+            if (item->title[0] != '\0') {
+                item->hash = hash_item_text(item);
+                rss_count++;
+                if (rss_count >= RSS_MAX_ITEMS) return false;
+            }
+        }
+        break;
+    case JSON_STREAM_STRING:
+    case JSON_STREAM_NUMBER:
+        if (!feed->in_item) break;
+        if (json_field_matches(feed, path, feed->title_field)) {
+            json_copy_text(item->title, RSS_TITLE_LEN + 1, value, value_len);
+        } else if (json_field_matches(feed, path, feed->desc_field)) {
+            json_copy_text(item->description, RSS_DESC_LEN + 1, value, value_len);
         }
         break;
     default:
         break;
     }
-    return ESP_OK;
+    return true;
 }
 
-// ── Public API ──
+static void stream_decode_json(rss_stream_t *stream, bool at_eof)
+{
+    json_stream_status_t status = json_stream_feed(&stream->json->parser,
+                                                   stream->window, stream->window_len);
+    stream_discard(stream, stream->window_len);
+    if (status == JSON_STREAM_OK && at_eof) {
+        status = json_stream_finish(&stream->json->parser);
+    }
 
-esp_err_t rss_fetch(const char *url)
+    if (status == JSON_STREAM_STOPPED) {
+        stream->complete = true;
+    } else if (status == JSON_STREAM_ERROR) {
+        ESP_LOGE(TAG, "Malformed JSON feed");
+        stream->error = ESP_ERR_INVALID_RESPONSE;
+    }
+}
+
+// Sniff the body format from its first bytes, then hand the window to its decoder.
+static void stream_process(rss_stream_t *stream, bool at_eof)
 {
-    if (!url || strlen(url) == 0) {
-        ESP_LOGE(TAG, "No RSS URL configured");
-        return ESP_ERR_INVALID_ARG;
+    if (stream->format == FEED_FORMAT_JSON) {
+        stream_decode_json(stream, at_eof);
+        return;
     }
+    if (stream->format == FEED_FORMAT_UNKNOWN) {
+        if (stream->window_len < SCROLLER_FEED_MAGIC_LEN && !at_eof) return;
+        bool binary = stream->window_len >= SCROLLER_FEED_MAGIC_LEN &&
+                      memcmp(stream->window, SCROLLER_FEED_MAGIC, SCROLLER_FEED_MAGIC_LEN) == 0;
+        stream->format = binary ? FEED_FORMAT_SCROLLER : FEED_FORMAT_RSS;
+    }
+
+    if (stream->format == FEED_FORMAT_SCROLLER) {
+        stream_decode_scroller(stream, at_eof);
+    } else {
+        stream_scan_items(stream);
+    }
+}
 
-    ESP_LOGI(TAG, "Fetching RSS: %s", url);
+static bool is_redirect_status(int status)
+{
+    return status == 301 || status == 302 || status == 303 ||
+           status == 307 || status == 308;
+}
 
-    // Allocate receive buffer (64KB max)
-    const int buf_size = 64 * 1024;
-    http_response_t resp = {
-        .buffer = malloc(buf_size),
-        .buffer_len = 0,
-        .buffer_size = buf_size,
-    };
+static bool deadline_reached(int64_t deadline_us)
+{
+    return deadline_us != 0 && esp_timer_get_time() >= deadline_us;
+}
 
-    if (!resp.buffer) {
+static esp_err_t fetch_feed(const char *url, const rss_fetch_options_t *options,
+                            bool is_json, int64_t deadline_us)
+{
+    rss_stream_t stream = {
+        .window = arena_alloc(&fetch_arena, RSS_STREAM_WINDOW_SIZE),
+        .window_len = 0,
+        .format = is_json ? FEED_FORMAT_JSON : FEED_FORMAT_UNKNOWN,
+    };
+    if (!stream.window) {
         ESP_LOGE(TAG, "Failed to allocate HTTP buffer");
         return ESP_ERR_NO_MEM;
     }
+    stream.window[0] = '\0';
+
+    if (is_json) {
+        stream.json = arena_calloc(&fetch_arena, sizeof(json_feed_t));
+        if (!stream.json) {
+            ESP_LOGE(TAG, "Failed to allocate JSON parser");
+            return ESP_ERR_NO_MEM;
+        }
+        if (!json_split_path(options->json_title_path, stream.json->item_path,
+                             sizeof(stream.json->item_path), &stream.json->title_field)) {
+            ESP_LOGE(TAG, "Invalid JSON title path: %s", options->json_title_path);
+            return ESP_ERR_INVALID_ARG;
+        }
+        char desc_item_path[JSON_STREAM_MAX_PATH + 1];
+        const char *desc_field = NULL;
+        if (json_split_path(options->json_desc_path, desc_item_path,
+                            sizeof(desc_item_path), &desc_field) &&
+            strcmp(desc_item_path, stream.json->item_path) == 0) {
+            stream.json->desc_field = desc_field;
+        } else if (options->json_desc_path && options->json_desc_path[0] != '\0') {
+            ESP_LOGW(TAG, "JSON description path '%s' is not under '%s'; ignoring",
+                     options->json_desc_path, stream.json->item_path);
+        }
+        json_stream_init(&stream.json->parser, json_feed_event, stream.json);
+    }
 
     esp_http_client_config_t config = {
         .url = url,
-        .event_handler = http_event_handler,
-        .user_data = &resp,
-        .timeout_ms = 10000,
+        .timeout_ms = (options && options->timeout_ms) ? (int)options->timeout_ms
+                                                       : RSS_FETCH_DEFAULT_TIMEOUT_MS,
         .crt_bundle_attach = esp_crt_bundle_attach,
         .buffer_size = 2048,
         .buffer_size_tx = 1024,
@@ -356,29 +645,138 @@ esp_err_t rss_fetch(const char *url)
 
     esp_http_client_handle_t client = esp_http_client_init(&config);
     if (!client) {
-        free(resp.buffer);
         ESP_LOGE(TAG, "Failed to init HTTP client");
         return ESP_FAIL;
     }
+    // Servers that know the scroller feed format answer with it; others send RSS.
+    esp_http_client_set_header(client, "Accept",
+                               is_json ? "application/json" : SCROLLER_FEED_ACCEPT);
+
+    // Redirects are followed by hand because the body is read incrementally.
+    esp_err_t err = ESP_OK;
+    int status = 0;
+    for (int redirects = 0; ; redirects++) {
+        // DNS, TCP and TLS all happen inside open().
+        trace_begin(TRACE_CAT_REFRESH, "http_connect", redirects);
+        err = esp_http_client_open(client, 0);
+        trace_end(TRACE_CAT_REFRESH, "http_connect", err);
+        if (err != ESP_OK) break;
+        trace_begin(TRACE_CAT_REFRESH, "http_first_byte", 0);
+        int header_len = esp_http_client_fetch_headers(client);
+        trace_end(TRACE_CAT_REFRESH, "http_first_byte", header_len);
+        if (header_len < 0) {
+            err = ESP_FAIL;
+            break;
+        }
+        status = esp_http_client_get_status_code(client);
+        if (!is_redirect_status(status) || redirects >= RSS_MAX_REDIRECTS) break;
+        esp_http_client_set_redirection(client);
+        esp_http_client_close(client);
+    }
+
+    int total_read = 0;
+    int64_t parse_us = 0;
+    bool stopped_early = false;
+    if (err == ESP_OK && deadline_reached(deadline_us)) {
+        ESP_LOGW(TAG, "Fetch deadline reached before reading the body");
+        err = ESP_ERR_TIMEOUT;
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "HTTP request failed: %s", esp_err_to_name(err));
+    } else if (status != 200) {
+        ESP_LOGE(TAG, "HTTP error: status=%d", status);
+        err = ESP_FAIL;
+    } else {
+        trace_begin(TRACE_CAT_REFRESH, "http_body", status);
+        while (rss_count < RSS_MAX_ITEMS && !stream.complete && stream.error == ESP_OK) {
+            if (deadline_reached(deadline_us)) {
+                ESP_LOGW(TAG, "Fetch deadline reached after %d bytes", total_read);
+                err = ESP_ERR_TIMEOUT;
+                break;
+            }
 
-    esp_err_t err = esp_http_client_perform(client);
-    if (err == ESP_OK) {
-        int status = esp_http_client_get_status_code(client);
-        ESP_LOGI(TAG, "HTTP status: %d, content length: %d", status, resp.buffer_len);
+            int space = RSS_STREAM_WINDOW_SIZE - 1 - stream.window_len;
+            if (space <= 0) {
+                // Item larger than the window; drop it and resync on the next <item>.
+                ESP_LOGW(TAG, "RSS item exceeds %d bytes; skipping", RSS_STREAM_WINDOW_SIZE);
+                stream_discard(&stream, stream.window_len);
+                continue;
+            }
 
-        if (status == 200 && resp.buffer_len > 0) {
-            resp.buffer[resp.buffer_len] = '\0';  // null-terminate
-            parse_rss_xml(resp.buffer, resp.buffer_len);
-        } else {
-            ESP_LOGE(TAG, "HTTP error: status=%d", status);
+            int n = esp_http_client_read(client, stream.window + stream.window_len, space);
+            if (n < 0) {
+                ESP_LOGE(TAG, "HTTP read failed after %d bytes", total_read);
+                err = ESP_FAIL;
+                break;
+            }
+            int64_t parse_start = esp_timer_get_time();
+            if (n == 0) {
+                stream_process(&stream, true);
+                parse_us += esp_timer_get_time() - parse_start;
+                break;
+            }
+
+            total_read += n;
+            stream.window_len += n;
+            stream.window[stream.window_len] = '\0';
+            stream_process(&stream, false);
+            parse_us += esp_timer_get_time() - parse_start;
+        }
+
+        last_fetch_bytes = total_read;
+        trace_end(TRACE_CAT_REFRESH, "http_body", total_read);
+        trace_instant(TRACE_CAT_REFRESH, "parse_us", (int32_t)parse_us);
+        stopped_early = (rss_count >= RSS_MAX_ITEMS &&
+                         !esp_http_client_is_complete_data_received(client));
+        static const char *const format_names[] = {"unknown", "rss", "scroller feed", "json"};
+        ESP_LOGI(TAG, "HTTP status: %d, read %d bytes (%s, %lld us parsing)%s", status, total_read,
+                 format_names[stream.format], (long long)parse_us,
+                 stopped_early ? ", item limit reached, closing early" : "");
+        if (err == ESP_OK && stream.error != ESP_OK) {
+            err = stream.error;
+        } else if (err == ESP_OK && total_read == 0) {
+            ESP_LOGE(TAG, "HTTP error: empty response");
             err = ESP_FAIL;
         }
-    } else {
-        ESP_LOGE(TAG, "HTTP request failed: %s", esp_err_to_name(err));
     }
 
+    // Closing before the body is drained drops the rest of the download.
+    esp_http_client_close(client);
     esp_http_client_cleanup(client);
-    free(resp.buffer);
+
+    if (err != ESP_OK) {
+        rss_count = 0;
+        return err;
+    }
+
+    ESP_LOGI(TAG, "Parsed %d feed items", rss_count);
+    return ESP_OK;
+}
+
+// ── Public API ──
+
+esp_err_t rss_fetch(const char *url)
+{
+    return rss_fetch_ex(url, NULL);
+}
+
+esp_err_t rss_fetch_ex(const char *url, const rss_fetch_options_t *options)
+{
+    if (!url || strlen(url) == 0) {
+        ESP_LOGE(TAG, "No RSS URL configured");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    bool is_json = options && options->json_title_path && options->json_title_path[0] != '\0';
+    int64_t deadline_us = options ? options->deadline_us : 0;
+    ESP_LOGI(TAG, "Fetching %s: %s", is_json ? "JSON" : "RSS", url);
+    rss_count = 0;
+    last_fetch_bytes = 0;
+    trace_begin(TRACE_CAT_REFRESH, "rss_fetch", is_json);
+    if (!fetch_arena.base) arena_init(&fetch_arena, fetch_arena_buf, sizeof(fetch_arena_buf));
+    esp_err_t err = fetch_feed(url, options, is_json, deadline_us);
+    arena_reset(&fetch_arena);
+    trace_end(TRACE_CAT_REFRESH, "rss_fetch", err);
     return err;
 }
 
@@ -387,6 +785,11 @@ int rss_get_count(void)
     return rss_count;
 }
 
+int rss_get_last_fetch_bytes(void)
+{
+    return last_fetch_bytes;
+}
+
 const rss_item_t *rss_get_item(int index)
 {
     if (index < 0 || index >= rss_count) {
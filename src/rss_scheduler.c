@@ -0,0 +1,302 @@
+#include "rss_scheduler.h"
+#include <string.h>
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_random.h"
+
+static const char *TAG = "rss_sched";
+
+typedef struct {
+    uint32_t url_hash;
+    char name[SETTINGS_MAX_RSS_NAME_LEN + 1];
+    TickType_t next_due;
+    uint32_t interval_ms;
+    uint32_t content_hash;
+    bool have_hash;
+    bool live;
+    uint16_t consecutive_failures;
+    esp_err_t last_error;
+} sched_source_t;
+
+static sched_source_t sched_sources[MAX_RSS_SOURCES];
+static int sched_source_count = 0;
+static SemaphoreHandle_t sched_mutex = NULL;
+
+static uint32_t hash_url(const char *s)
+{
+    uint32_t hash = 2166136261u;
+    if (!s) return hash;
+    while (*s) {
+        hash ^= (uint8_t)*s++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static bool tick_reached(TickType_t now, TickType_t deadline)
+{
+    return (int32_t)(now - deadline) >= 0;
+}
+
+static sched_source_t *find_source(const char *url)
+{
+    uint32_t h = hash_url(url);
+    for (int i = 0; i < sched_source_count; i++) {
+        if (sched_sources[i].url_hash == h) return &sched_sources[i];
+    }
+    return NULL;
+}
+
+static uint32_t clamp_interval(uint32_t ms)
+{
+    if (ms < RSS_SCHED_MIN_INTERVAL_MS) return RSS_SCHED_MIN_INTERVAL_MS;
+    if (ms > RSS_SCHED_MAX_INTERVAL_MS) return RSS_SCHED_MAX_INTERVAL_MS;
+    return ms;
+}
+
+static uint32_t backoff_delay_ms(uint16_t failures)
+{
+    uint32_t delay = RSS_SCHED_RETRY_MS;
+    for (uint16_t i = 1; i < failures && delay < RSS_SCHED_BACKOFF_MAX_MS; i++) {
+        delay *= 2;
+    }
+    if (delay > RSS_SCHED_BACKOFF_MAX_MS) delay = RSS_SCHED_BACKOFF_MAX_MS;
+
+    // Spread retries so sources that failed together don't retry together.
+    uint32_t jitter = delay / 4;
+    return delay - jitter + (esp_random() % (2 * jitter + 1));
+}
+
+// False until rss_scheduler_init() has created the mutex; callers then
+// behave as if no source were scheduled.
+static bool sched_lock(void)
+{
+    if (!sched_mutex) return false;
+    xSemaphoreTake(sched_mutex, portMAX_DELAY);
+    return true;
+}
+
+esp_err_t rss_scheduler_init(void)
+{
+    if (!sched_mutex) {
+        sched_mutex = xSemaphoreCreateMutex();
+        if (!sched_mutex) return ESP_ERR_NO_MEM;
+    }
+    sched_source_count = 0;
+    return ESP_OK;
+}
+
+void rss_scheduler_sync(const app_settings_t *s, TickType_t now)
+{
+    sched_source_t previous[MAX_RSS_SOURCES];
+
+    if (!sched_lock()) return;
+    int previous_count = sched_source_count;
+    memcpy(previous, sched_sources, sizeof(previous));
+
+    sched_source_count = 0;
+    if (!s || !s->rss_enabled) {
+        xSemaphoreGive(sched_mutex);
+        return;
+    }
+
+    int count = s->rss_source_count;
+    if (count > MAX_RSS_SOURCES) count = MAX_RSS_SOURCES;
+
+    for (int i = 0; i < count; i++) {
+        const rss_source_t *src = &s->rss_sources[i];
+        if (!src->enabled || src->url[0] == '\0') continue;
+
+        uint32_t h = hash_url(src->url);
+        sched_source_t *entry = &sched_sources[sched_source_count++];
+
+        bool kept = false;
+        for (int j = 0; j < previous_count; j++) {
+            if (previous[j].url_hash == h) {
+                *entry = previous[j];
+                kept = true;
+                break;
+            }
+        }
+        if (!kept) {
+            memset(entry, 0, sizeof(*entry));
+            entry->url_hash = h;
+            entry->next_due = now;
+            entry->interval_ms = RSS_SCHED_DEFAULT_INTERVAL_MS;
+        }
+        strncpy(entry->name, src->name, SETTINGS_MAX_RSS_NAME_LEN);
+        entry->name[SETTINGS_MAX_RSS_NAME_LEN] = '\0';
+    }
+    xSemaphoreGive(sched_mutex);
+}
+
+static bool entry_is_due(const sched_source_t *entry, TickType_t now)
+{
+    // Sources in backoff get no early batching; they wait out the full delay.
+    TickType_t horizon = now;
+    if (entry->consecutive_failures == 0) {
+        horizon += pdMS_TO_TICKS(RSS_SCHED_BATCH_SLACK_MS);
+    }
+    return tick_reached(horizon, entry->next_due);
+}
+
+// True if a should be fetched before b.
+static bool plan_before(const sched_source_t *a, const sched_source_t *b, TickType_t now)
+{
+    if (a->live != b->live) return a->live;
+    bool a_healthy = a->consecutive_failures == 0;
+    bool b_healthy = b->consecutive_failures == 0;
+    if (a_healthy != b_healthy) return a_healthy;
+    return (int32_t)(now - a->next_due) > (int32_t)(now - b->next_due);
+}
+
+int rss_scheduler_plan(const app_settings_t *s, TickType_t now, int *order, int max)
+{
+    if (!s || !order || max <= 0) return 0;
+
+    const sched_source_t *entries[MAX_RSS_SOURCES];
+    int count = s->rss_source_count;
+    if (count > MAX_RSS_SOURCES) count = MAX_RSS_SOURCES;
+    int planned = 0;
+
+    if (!sched_lock()) return 0;
+    for (int i = 0; i < count && planned < max; i++) {
+        const rss_source_t *src = &s->rss_sources[i];
+        if (!src->enabled || src->url[0] == '\0') continue;
+
+        const sched_source_t *entry = find_source(src->url);
+        if (!entry || !entry_is_due(entry, now)) continue;
+
+        // Insertion sort; at most MAX_RSS_SOURCES entries.
+        int pos = planned++;
+        while (pos > 0 && plan_before(entry, entries[pos - 1], now)) {
+            entries[pos] = entries[pos - 1];
+            order[pos] = order[pos - 1];
+            pos--;
+        }
+        entries[pos] = entry;
+        order[pos] = i;
+    }
+    xSemaphoreGive(sched_mutex);
+    return planned;
+}
+
+void rss_scheduler_record_success(const char *url, const rss_cache_source_info_t *info,
+                                  TickType_t now)
+{
+    if (!info || !sched_lock()) return;
+
+    sched_source_t *entry = find_source(url);
+    if (!entry) {
+        xSemaphoreGive(sched_mutex);
+        return;
+    }
+
+    if (entry->consecutive_failures > 0) {
+        ESP_LOGI(TAG, "'%s': recovered after %u failures", entry->name,
+                 (unsigned)entry->consecutive_failures);
+    }
+    entry->consecutive_failures = 0;
+    entry->last_error = ESP_OK;
+
+    bool changed = entry->have_hash && info->content_hash != entry->content_hash;
+    bool was_live = entry->live;
+
+    if (info->live_count > 0) {
+        // Live scores go stale within minutes.
+        entry->interval_ms = RSS_SCHED_LIVE_INTERVAL_MS;
+    } else if (was_live) {
+        // Games just ended; finals and next fixtures are still settling.
+        entry->interval_ms = RSS_SCHED_MIN_INTERVAL_MS;
+    } else if (changed) {
+        entry->interval_ms = clamp_interval(entry->interval_ms / 2);
+    } else if (entry->have_hash) {
+        entry->interval_ms = clamp_interval(entry->interval_ms + entry->interval_ms / 2);
+    }
+
+    entry->content_hash = info->content_hash;
+    entry->have_hash = true;
+    entry->live = info->live_count > 0;
+    entry->next_due = now + pdMS_TO_TICKS(entry->interval_ms);
+
+    ESP_LOGI(TAG, "'%s': %s, %u live, next refresh in %us", entry->name,
+             changed ? "changed" : "unchanged", (unsigned)info->live_count,
+             (unsigned)(entry->interval_ms / 1000));
+    xSemaphoreGive(sched_mutex);
+}
+
+void rss_scheduler_record_failure(const char *url, esp_err_t err, TickType_t now)
+{
+    if (!sched_lock()) return;
+    sched_source_t *entry = find_source(url);
+    if (!entry) {
+        xSemaphoreGive(sched_mutex);
+        return;
+    }
+
+    if (entry->consecutive_failures < UINT16_MAX) {
+        entry->consecutive_failures++;
+    }
+    entry->last_error = err;
+
+    uint32_t delay_ms = backoff_delay_ms(entry->consecutive_failures);
+    entry->next_due = now + pdMS_TO_TICKS(delay_ms);
+    ESP_LOGW(TAG, "'%s': fetch failed (%s), failure %u, retry in %us", entry->name,
+             esp_err_to_name(err), (unsigned)entry->consecutive_failures,
+             (unsigned)(delay_ms / 1000));
+    xSemaphoreGive(sched_mutex);
+}
+
+void rss_scheduler_defer(const char *url, TickType_t now, uint32_t delay_ms)
+{
+    if (!sched_lock()) return;
+    sched_source_t *entry = find_source(url);
+    if (entry) {
+        entry->next_due = now + pdMS_TO_TICKS(delay_ms);
+    }
+    xSemaphoreGive(sched_mutex);
+}
+
+void rss_scheduler_defer_due(TickType_t now, uint32_t delay_ms)
+{
+    if (!sched_lock()) return;
+    TickType_t horizon = now + pdMS_TO_TICKS(RSS_SCHED_BATCH_SLACK_MS);
+    for (int i = 0; i < sched_source_count; i++) {
+        if (tick_reached(horizon, sched_sources[i].next_due)) {
+            sched_sources[i].next_due = now + pdMS_TO_TICKS(delay_ms);
+        }
+    }
+    xSemaphoreGive(sched_mutex);
+}
+
+bool rss_scheduler_get_health(const char *url, TickType_t now, rss_source_health_t *out)
+{
+    if (!out || !sched_lock()) return false;
+
+    sched_source_t *entry = find_source(url);
+    if (entry) {
+        memcpy(out->name, entry->name, sizeof(out->name));
+        out->interval_ms = entry->interval_ms;
+        int32_t remaining = (int32_t)(entry->next_due - now);
+        out->next_attempt_ms = remaining > 0 ? (uint32_t)remaining * portTICK_PERIOD_MS : 0;
+        out->consecutive_failures = entry->consecutive_failures;
+        out->last_error = entry->last_error;
+        out->fetched = entry->have_hash;
+        out->live = entry->live;
+    }
+    xSemaphoreGive(sched_mutex);
+    return entry != NULL;
+}
+
+TickType_t rss_scheduler_next_due(TickType_t now)
+{
+    TickType_t earliest = now + pdMS_TO_TICKS(RSS_SCHED_DEFAULT_INTERVAL_MS);
+    if (!sched_lock()) return earliest;
+    for (int i = 0; i < sched_source_count; i++) {
+        if (i == 0 || (int32_t)(sched_sources[i].next_due - earliest) < 0) {
+            earliest = sched_sources[i].next_due;
+        }
+    }
+    xSemaphoreGive(sched_mutex);
+    return earliest;
+}
@@ -1,18 +1,72 @@
 #include "settings.h"
 #include "storage_paths.h"
+#include "metrics.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
+#include <stdatomic.h>
 #include <ctype.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
 #include "nvs_flash.h"
 #include "nvs.h"
 #include "esp_log.h"
+#include "esp_rom_crc.h"
 #include "cJSON.h"
 
 static const char *TAG = "settings";
 static const char *NVS_NAMESPACE = "mancave";
 
-static app_settings_t current_settings;
+// Settings live in one NVS blob: a header followed by the persisted prefix
+// of app_settings_t (everything before rss_source_count; the source list is
+// rebuilt from the flags on load). Add new persisted fields at the end of
+// that prefix: a shorter payload of the same version loads over defaults.
+// Bump SETTINGS_BLOB_VERSION when existing fields move or change size.
+#define SETTINGS_BLOB_KEY     "settings"
+#define SETTINGS_BLOB_VERSION 1
+#define SETTINGS_PAYLOAD_LEN  offsetof(app_settings_t, rss_source_count)
+
+typedef struct {
+    uint16_t version;
+    uint16_t payload_len;
+    uint32_t crc32;  // esp_rom_crc32_le() over the payload
+} settings_blob_header_t;
+
+// Readers get immutable snapshots from a small pool. Each edit copies the
+// published snapshot into a free slot, changes the copy and publishes it
+// with one atomic pointer swap, so readers never see a half-applied change
+// and never take a lock.
+#define SETTINGS_SNAPSHOT_COUNT   4
+#define SETTINGS_CLAIM_ATTEMPTS   100  // x 10 ms
+#define SETTINGS_MAX_SUBSCRIBERS  4
+
+typedef struct {
+    app_settings_t data;  // first member: snapshot pointers cast back to their slot
+    atomic_int refs;      // reader references, plus one while published or being edited
+} settings_slot_t;
+
+typedef struct {
+    settings_change_cb_t cb;
+    void *ctx;
+} settings_subscriber_t;
+
+static settings_slot_t slots[SETTINGS_SNAPSHOT_COUNT];
+static _Atomic(settings_slot_t *) published = NULL;
+static atomic_uint generation = 0;
+static SemaphoreHandle_t edit_mutex = NULL;  // one edit at a time; guards subscribers
+static settings_subscriber_t subscribers[SETTINGS_MAX_SUBSCRIBERS];
+static int subscriber_count = 0;
+
+static uint32_t stored_crc = 0;
+static bool stored_valid = false;  // stored_crc matches the blob in flash
+
+// Guards dirty_fields and serializes NVS writes between the flush task
+// and explicit settings_flush() calls.
+static SemaphoreHandle_t settings_mutex = NULL;
+static TaskHandle_t flush_task_handle = NULL;
+static uint32_t dirty_fields = 0;
 
 static bool ends_with_php(const char *s)
 {
@@ -108,7 +162,8 @@ static void build_espn_feed_url(const char *base_url, const char *sport_code, ch
     snprintf(out, out_size, "%sespn_scores_rss.php?sport=%s&format=rss", base_url, sport_code);
 }
 
-static void add_rss_source(app_settings_t *s, const char *name, const char *url)
+static void add_rss_source(app_settings_t *s, const char *name, const char *url,
+                           rss_source_type_t type)
 {
     if (!s || !name || !url || url[0] == '\0' || s->rss_source_count >= MAX_RSS_SOURCES) {
         return;
@@ -120,6 +175,21 @@ static void add_rss_source(app_settings_t *s, const char *name, const char *url)
     s->rss_sources[idx].name[SETTINGS_MAX_RSS_NAME_LEN] = '\0';
     strncpy(s->rss_sources[idx].url, url, SETTINGS_MAX_URL_LEN);
     s->rss_sources[idx].url[SETTINGS_MAX_URL_LEN] = '\0';
+    s->rss_sources[idx].type = (uint8_t)type;
+}
+
+static void add_json_source(app_settings_t *s, const char *name, const char *url,
+                            const char *title_path, const char *desc_path)
+{
+    int idx = s->rss_source_count;
+    add_rss_source(s, name, url, RSS_SOURCE_TYPE_JSON);
+    if (s->rss_source_count == idx) return;
+
+    rss_source_t *src = &s->rss_sources[idx];
+    strncpy(src->json_title_path, title_path, SETTINGS_MAX_JSON_PATH_LEN);
+    src->json_title_path[SETTINGS_MAX_JSON_PATH_LEN] = '\0';
+    strncpy(src->json_desc_path, desc_path, SETTINGS_MAX_JSON_PATH_LEN);
+    src->json_desc_path[SETTINGS_MAX_JSON_PATH_LEN] = '\0';
 }
 
 static void rebuild_rss_sources(app_settings_t *s)
@@ -127,6 +197,9 @@ static void rebuild_rss_sources(app_settings_t *s)
     if (!s) return;
 
     trim_ascii(s->rss_url);
+    trim_ascii(s->rss_json_url);
+    trim_ascii(s->rss_json_title_path);
+    trim_ascii(s->rss_json_desc_path);
 
     char normalized_base[SETTINGS_MAX_URL_LEN + 1] = {0};
     normalize_sports_base_url(s->rss_sports_base_url, normalized_base, sizeof(normalized_base));
@@ -141,38 +214,43 @@ static void rebuild_rss_sources(app_settings_t *s)
     }
 
     // Feed manifest order is fixed so display/caching logic can rely on stable indices:
-    // MLB, NHL, NCAAF, NFL, NBA, BIG10, NPR.
+    // MLB, NHL, NCAAF, NFL, NBA, BIG10, NPR, JSON.
     if (s->rss_sports_enabled && normalized_base[0] != '\0') {
         char sport_url[SETTINGS_MAX_URL_LEN + 1] = {0};
 
         if (s->rss_sport_mlb_enabled) {
             build_espn_feed_url(normalized_base, "mlb", sport_url, sizeof(sport_url));
-            add_rss_source(s, "MLB Scores", sport_url);
+            add_rss_source(s, "MLB Scores", sport_url, RSS_SOURCE_TYPE_RSS);
         }
         if (s->rss_sport_nhl_enabled) {
             build_espn_feed_url(normalized_base, "nhl", sport_url, sizeof(sport_url));
-            add_rss_source(s, "NHL Scores", sport_url);
+            add_rss_source(s, "NHL Scores", sport_url, RSS_SOURCE_TYPE_RSS);
         }
         if (s->rss_sport_ncaaf_enabled) {
             build_espn_feed_url(normalized_base, "ncaaf", sport_url, sizeof(sport_url));
-            add_rss_source(s, "NCAAF Scores", sport_url);
+            add_rss_source(s, "NCAAF Scores", sport_url, RSS_SOURCE_TYPE_RSS);
         }
         if (s->rss_sport_nfl_enabled) {
             build_espn_feed_url(normalized_base, "nfl", sport_url, sizeof(sport_url));
-            add_rss_source(s, "NFL Scores", sport_url);
+            add_rss_source(s, "NFL Scores", sport_url, RSS_SOURCE_TYPE_RSS);
         }
         if (s->rss_sport_nba_enabled) {
             build_espn_feed_url(normalized_base, "nba", sport_url, sizeof(sport_url));
-            add_rss_source(s, "NBA Scores", sport_url);
+            add_rss_source(s, "NBA Scores", sport_url, RSS_SOURCE_TYPE_RSS);
         }
         if (s->rss_sport_big10_enabled) {
             build_espn_feed_url(normalized_base, "big10", sport_url, sizeof(sport_url));
-            add_rss_source(s, "Big 10 Scores", sport_url);
+            add_rss_source(s, "Big 10 Scores", sport_url, RSS_SOURCE_TYPE_RSS);
         }
     }
 
     if (s->rss_npr_enabled && s->rss_url[0] != '\0') {
-        add_rss_source(s, "NPR News", s->rss_url);
+        add_rss_source(s, "NPR News", s->rss_url, RSS_SOURCE_TYPE_RSS);
+    }
+
+    if (s->rss_json_enabled && s->rss_json_url[0] != '\0' && s->rss_json_title_path[0] != '\0') {
+        add_json_source(s, s->rss_json_name[0] != '\0' ? s->rss_json_name : "JSON Feed",
+                        s->rss_json_url, s->rss_json_title_path, s->rss_json_desc_path);
     }
 }
 
@@ -204,6 +282,7 @@ static void set_factory_defaults(app_settings_t *s)
     s->speed = 5;
     s->brightness = 32;
     s->panel_cols = 32;
+    strncpy(s->wifi_static_netmask, "255.255.255.0", SETTINGS_MAX_IP_LEN);
     s->rss_enabled = true;
     strncpy(s->rss_url, "https://feeds.npr.org/1001/rss.xml", SETTINGS_MAX_URL_LEN);
     s->rss_url[SETTINGS_MAX_URL_LEN] = '\0';
@@ -216,6 +295,12 @@ static void set_factory_defaults(app_settings_t *s)
     s->rss_sport_nfl_enabled = true;
     s->rss_sport_nba_enabled = true;
     s->rss_sport_big10_enabled = true;
+    s->rss_json_enabled = false;
+    strncpy(s->rss_json_name, "JSON Feed", SETTINGS_MAX_RSS_NAME_LEN);
+    strncpy(s->rss_json_title_path, "events[].name", SETTINGS_MAX_JSON_PATH_LEN);
+    strncpy(s->rss_json_desc_path, "events[].status.type.detail", SETTINGS_MAX_JSON_PATH_LEN);
+    s->rss_refresh_budget_s = 30;
+    s->rss_background_refresh = false;
     rebuild_rss_sources(s);
 }
 
@@ -310,29 +395,37 @@ static void load_default_settings(app_settings_t *s)
     rebuild_rss_sources(s);
 }
 
-static void load_from_nvs(void)
+// Per-key layout used before the settings blob; read once for migration,
+// then erased.
+static const char *const legacy_keys[] = {
+    "speed", "bright", "panel_cols", "wifi_ssid", "wifi_pass",
+    "wifi_st_en", "wifi_st_ip", "wifi_st_gw", "wifi_st_mask", "wifi_st_dns",
+    "rss_en", "rss_url", "rss_npr_en", "rss_sports_en", "rss_sports_base",
+    "rss_mlb_en", "rss_nhl_en", "rss_ncaaf_en", "rss_nfl_en", "rss_nba_en", "rss_big10_en",
+    "rss_json_en", "rss_json_name", "rss_json_url", "rss_json_tpath", "rss_json_dpath",
+    "rss_budget", "rss_bg_refresh", "rss_count",
+};
+
+static bool has_legacy_keys(nvs_handle_t handle)
 {
-    nvs_handle_t handle;
-    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle);
-    if (err != ESP_OK) {
-        ESP_LOGI(TAG, "No saved settings, using defaults");
-        load_default_settings(&current_settings);
-        return;
-    }
-
-    // Start with defaults, then override with stored values.
-    load_default_settings(&current_settings);
+    uint8_t probe = 0;
+    size_t len = 0;
+    return nvs_get_u8(handle, "speed", &probe) == ESP_OK ||
+           nvs_get_str(handle, "text", NULL, &len) == ESP_OK;
+}
 
+static void load_legacy_keys(nvs_handle_t handle, app_settings_t *s)
+{
     // Migrate old single-message format if present.
     char old_text[SETTINGS_MAX_TEXT_LEN + 1] = "";
     size_t len = sizeof(old_text);
     if (nvs_get_str(handle, "text", old_text, &len) == ESP_OK && strlen(old_text) > 0) {
         ESP_LOGI(TAG, "Migrating old single-message to messages[0]");
-        strncpy(current_settings.messages[0].text, old_text, SETTINGS_MAX_TEXT_LEN);
-        current_settings.messages[0].enabled = true;
-        nvs_get_u8(handle, "color_r", &current_settings.messages[0].color_r);
-        nvs_get_u8(handle, "color_g", &current_settings.messages[0].color_g);
-        nvs_get_u8(handle, "color_b", &current_settings.messages[0].color_b);
+        strncpy(s->messages[0].text, old_text, SETTINGS_MAX_TEXT_LEN);
+        s->messages[0].enabled = true;
+        nvs_get_u8(handle, "color_r", &s->messages[0].color_r);
+        nvs_get_u8(handle, "color_g", &s->messages[0].color_g);
+        nvs_get_u8(handle, "color_b", &s->messages[0].color_b);
         nvs_erase_key(handle, "text");
         nvs_erase_key(handle, "color_r");
         nvs_erase_key(handle, "color_g");
@@ -345,164 +438,467 @@ static void load_from_nvs(void)
         char key[16];
 
         snprintf(key, sizeof(key), "msg%d_text", i);
-        len = sizeof(current_settings.messages[i].text);
-        nvs_get_str(handle, key, current_settings.messages[i].text, &len);
+        len = sizeof(s->messages[i].text);
+        nvs_get_str(handle, key, s->messages[i].text, &len);
 
         snprintf(key, sizeof(key), "msg%d_r", i);
-        nvs_get_u8(handle, key, &current_settings.messages[i].color_r);
+        nvs_get_u8(handle, key, &s->messages[i].color_r);
 
         snprintf(key, sizeof(key), "msg%d_g", i);
-        nvs_get_u8(handle, key, &current_settings.messages[i].color_g);
+        nvs_get_u8(handle, key, &s->messages[i].color_g);
 
         snprintf(key, sizeof(key), "msg%d_b", i);
-        nvs_get_u8(handle, key, &current_settings.messages[i].color_b);
+        nvs_get_u8(handle, key, &s->messages[i].color_b);
 
         snprintf(key, sizeof(key), "msg%d_en", i);
-        uint8_t en = current_settings.messages[i].enabled ? 1 : 0;
+        uint8_t en = s->messages[i].enabled ? 1 : 0;
         nvs_get_u8(handle, key, &en);
-        current_settings.messages[i].enabled = (en != 0);
+        s->messages[i].enabled = (en != 0);
     }
 
-    nvs_get_u8(handle, "speed", &current_settings.speed);
-    nvs_get_u8(handle, "bright", &current_settings.brightness);
-    nvs_get_u8(handle, "panel_cols", &current_settings.panel_cols);
+    nvs_get_u8(handle, "speed", &s->speed);
+    nvs_get_u8(handle, "bright", &s->brightness);
+    nvs_get_u8(handle, "panel_cols", &s->panel_cols);
+
+    len = sizeof(s->wifi_ssid);
+    nvs_get_str(handle, "wifi_ssid", s->wifi_ssid, &len);
+
+    len = sizeof(s->wifi_password);
+    nvs_get_str(handle, "wifi_pass", s->wifi_password, &len);
+
+    uint8_t static_en = s->wifi_static_enabled ? 1 : 0;
+    nvs_get_u8(handle, "wifi_st_en", &static_en);
+    s->wifi_static_enabled = (static_en != 0);
+
+    len = sizeof(s->wifi_static_ip);
+    nvs_get_str(handle, "wifi_st_ip", s->wifi_static_ip, &len);
 
-    len = sizeof(current_settings.wifi_ssid);
-    nvs_get_str(handle, "wifi_ssid", current_settings.wifi_ssid, &len);
+    len = sizeof(s->wifi_static_gateway);
+    nvs_get_str(handle, "wifi_st_gw", s->wifi_static_gateway, &len);
 
-    len = sizeof(current_settings.wifi_password);
-    nvs_get_str(handle, "wifi_pass", current_settings.wifi_password, &len);
+    len = sizeof(s->wifi_static_netmask);
+    nvs_get_str(handle, "wifi_st_mask", s->wifi_static_netmask, &len);
 
-    uint8_t rss_en = current_settings.rss_enabled ? 1 : 0;
+    len = sizeof(s->wifi_static_dns);
+    nvs_get_str(handle, "wifi_st_dns", s->wifi_static_dns, &len);
+
+    uint8_t rss_en = s->rss_enabled ? 1 : 0;
     nvs_get_u8(handle, "rss_en", &rss_en);
-    current_settings.rss_enabled = (rss_en != 0);
+    s->rss_enabled = (rss_en != 0);
 
-    len = sizeof(current_settings.rss_url);
-    nvs_get_str(handle, "rss_url", current_settings.rss_url, &len);
+    len = sizeof(s->rss_url);
+    nvs_get_str(handle, "rss_url", s->rss_url, &len);
 
-    uint8_t rss_npr_en = current_settings.rss_npr_enabled ? 1 : 0;
+    uint8_t rss_npr_en = s->rss_npr_enabled ? 1 : 0;
     nvs_get_u8(handle, "rss_npr_en", &rss_npr_en);
-    current_settings.rss_npr_enabled = (rss_npr_en != 0);
+    s->rss_npr_enabled = (rss_npr_en != 0);
 
-    uint8_t rss_sports_en = current_settings.rss_sports_enabled ? 1 : 0;
+    uint8_t rss_sports_en = s->rss_sports_enabled ? 1 : 0;
     nvs_get_u8(handle, "rss_sports_en", &rss_sports_en);
-    current_settings.rss_sports_enabled = (rss_sports_en != 0);
+    s->rss_sports_enabled = (rss_sports_en != 0);
 
-    len = sizeof(current_settings.rss_sports_base_url);
-    nvs_get_str(handle, "rss_sports_base", current_settings.rss_sports_base_url, &len);
+    len = sizeof(s->rss_sports_base_url);
+    nvs_get_str(handle, "rss_sports_base", s->rss_sports_base_url, &len);
 
-    uint8_t sport_en = current_settings.rss_sport_mlb_enabled ? 1 : 0;
+    uint8_t sport_en = s->rss_sport_mlb_enabled ? 1 : 0;
     nvs_get_u8(handle, "rss_mlb_en", &sport_en);
-    current_settings.rss_sport_mlb_enabled = (sport_en != 0);
+    s->rss_sport_mlb_enabled = (sport_en != 0);
 
-    sport_en = current_settings.rss_sport_nhl_enabled ? 1 : 0;
+    sport_en = s->rss_sport_nhl_enabled ? 1 : 0;
     nvs_get_u8(handle, "rss_nhl_en", &sport_en);
-    current_settings.rss_sport_nhl_enabled = (sport_en != 0);
+    s->rss_sport_nhl_enabled = (sport_en != 0);
 
-    sport_en = current_settings.rss_sport_ncaaf_enabled ? 1 : 0;
+    sport_en = s->rss_sport_ncaaf_enabled ? 1 : 0;
     nvs_get_u8(handle, "rss_ncaaf_en", &sport_en);
-    current_settings.rss_sport_ncaaf_enabled = (sport_en != 0);
+    s->rss_sport_ncaaf_enabled = (sport_en != 0);
 
-    sport_en = current_settings.rss_sport_nfl_enabled ? 1 : 0;
+    sport_en = s->rss_sport_nfl_enabled ? 1 : 0;
     nvs_get_u8(handle, "rss_nfl_en", &sport_en);
-    current_settings.rss_sport_nfl_enabled = (sport_en != 0);
+    s->rss_sport_nfl_enabled = (sport_en != 0);
 
-    sport_en = current_settings.rss_sport_nba_enabled ? 1 : 0;
+    sport_en = s->rss_sport_nba_enabled ? 1 : 0;
     nvs_get_u8(handle, "rss_nba_en", &sport_en);
-    current_settings.rss_sport_nba_enabled = (sport_en != 0);
+    s->rss_sport_nba_enabled = (sport_en != 0);
 
-    sport_en = current_settings.rss_sport_big10_enabled ? 1 : 0;
+    sport_en = s->rss_sport_big10_enabled ? 1 : 0;
     nvs_get_u8(handle, "rss_big10_en", &sport_en);
-    current_settings.rss_sport_big10_enabled = (sport_en != 0);
+    s->rss_sport_big10_enabled = (sport_en != 0);
 
-    rebuild_rss_sources(&current_settings);
+    uint8_t rss_json_en = s->rss_json_enabled ? 1 : 0;
+    nvs_get_u8(handle, "rss_json_en", &rss_json_en);
+    s->rss_json_enabled = (rss_json_en != 0);
 
-    nvs_close(handle);
-    ESP_LOGI(TAG, "Settings loaded from NVS");
+    len = sizeof(s->rss_json_name);
+    nvs_get_str(handle, "rss_json_name", s->rss_json_name, &len);
+
+    len = sizeof(s->rss_json_url);
+    nvs_get_str(handle, "rss_json_url", s->rss_json_url, &len);
+
+    len = sizeof(s->rss_json_title_path);
+    nvs_get_str(handle, "rss_json_tpath", s->rss_json_title_path, &len);
+
+    len = sizeof(s->rss_json_desc_path);
+    nvs_get_str(handle, "rss_json_dpath", s->rss_json_desc_path, &len);
+
+    nvs_get_u8(handle, "rss_budget", &s->rss_refresh_budget_s);
+
+    uint8_t rss_bg = s->rss_background_refresh ? 1 : 0;
+    nvs_get_u8(handle, "rss_bg_refresh", &rss_bg);
+    s->rss_background_refresh = (rss_bg != 0);
 }
 
-esp_err_t settings_init(void)
+static void erase_legacy_keys(nvs_handle_t handle)
 {
-    load_from_nvs();
-    return ESP_OK;
+    for (size_t i = 0; i < sizeof(legacy_keys) / sizeof(legacy_keys[0]); i++) {
+        nvs_erase_key(handle, legacy_keys[i]);
+    }
+
+    char key[20];
+    for (int i = 0; i < MAX_MESSAGES; i++) {
+        static const char *const fields[] = {"text", "r", "g", "b", "en"};
+        for (size_t f = 0; f < sizeof(fields) / sizeof(fields[0]); f++) {
+            snprintf(key, sizeof(key), "msg%d_%s", i, fields[f]);
+            nvs_erase_key(handle, key);
+        }
+    }
+    for (int i = 0; i < MAX_RSS_SOURCES; i++) {
+        static const char *const fields[] = {"en", "name", "url"};
+        for (size_t f = 0; f < sizeof(fields) / sizeof(fields[0]); f++) {
+            snprintf(key, sizeof(key), "rs%d_%s", i, fields[f]);
+            nvs_erase_key(handle, key);
+        }
+    }
+}
+
+static uint32_t payload_crc(const app_settings_t *s)
+{
+    return esp_rom_crc32_le(0, (const uint8_t *)s, SETTINGS_PAYLOAD_LEN);
+}
+
+// Read and verify the settings blob into s. On any error s is left untouched.
+static esp_err_t read_settings_blob(nvs_handle_t handle, app_settings_t *s)
+{
+    size_t size = 0;
+    esp_err_t err = nvs_get_blob(handle, SETTINGS_BLOB_KEY, NULL, &size);
+    if (err != ESP_OK) return err;
+    if (size < sizeof(settings_blob_header_t) ||
+        size > sizeof(settings_blob_header_t) + SETTINGS_PAYLOAD_LEN) {
+        ESP_LOGE(TAG, "Settings blob has unexpected size %u", (unsigned)size);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    uint8_t *buf = malloc(size);
+    if (!buf) return ESP_ERR_NO_MEM;
+
+    err = nvs_get_blob(handle, SETTINGS_BLOB_KEY, buf, &size);
+    if (err != ESP_OK) {
+        free(buf);
+        return err;
+    }
+
+    settings_blob_header_t header;
+    memcpy(&header, buf, sizeof(header));
+    const uint8_t *payload = buf + sizeof(header);
+
+    if (header.version != SETTINGS_BLOB_VERSION) {
+        ESP_LOGW(TAG, "Settings blob version %u not supported (want %u)",
+                 (unsigned)header.version, (unsigned)SETTINGS_BLOB_VERSION);
+        err = ESP_ERR_INVALID_VERSION;
+    } else if (header.payload_len != size - sizeof(header)) {
+        ESP_LOGE(TAG, "Settings blob length mismatch");
+        err = ESP_ERR_INVALID_SIZE;
+    } else if (esp_rom_crc32_le(0, payload, header.payload_len) != header.crc32) {
+        ESP_LOGE(TAG, "Settings blob CRC mismatch");
+        err = ESP_ERR_INVALID_CRC;
+    } else {
+        // Fields added since this blob was written keep their defaults.
+        memcpy(s, payload, header.payload_len);
+        if (header.payload_len == SETTINGS_PAYLOAD_LEN) {
+            stored_crc = header.crc32;
+            stored_valid = true;
+        }
+    }
+
+    free(buf);
+    return err;
+}
+
+static esp_err_t write_settings_blob(nvs_handle_t handle, const app_settings_t *s)
+{
+    size_t size = sizeof(settings_blob_header_t) + SETTINGS_PAYLOAD_LEN;
+    uint8_t *buf = malloc(size);
+    if (!buf) return ESP_ERR_NO_MEM;
+
+    settings_blob_header_t header = {
+        .version = SETTINGS_BLOB_VERSION,
+        .payload_len = SETTINGS_PAYLOAD_LEN,
+        .crc32 = payload_crc(s),
+    };
+    memcpy(buf, &header, sizeof(header));
+    memcpy(buf + sizeof(header), s, SETTINGS_PAYLOAD_LEN);
+
+    esp_err_t err = nvs_set_blob(handle, SETTINGS_BLOB_KEY, buf, size);
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    }
+    free(buf);
+
+    if (err == ESP_OK) {
+        metrics_add(METRIC_NVS_WRITE_BYTES, size);
+        stored_crc = header.crc32;
+        stored_valid = true;
+    }
+    return err;
 }
 
-esp_err_t settings_save(const app_settings_t *settings)
+static void load_from_nvs(app_settings_t *s)
 {
     nvs_handle_t handle;
     esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle);
     if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to open NVS: %s", esp_err_to_name(err));
-        return err;
+        ESP_LOGI(TAG, "No saved settings, using defaults");
+        load_default_settings(s);
+        return;
     }
 
-    memcpy(&current_settings, settings, sizeof(app_settings_t));
-    rebuild_rss_sources(&current_settings);
+    // Start with defaults, then override with stored values.
+    load_default_settings(s);
 
-    for (int i = 0; i < MAX_MESSAGES; i++) {
-        char key[16];
+    err = read_settings_blob(handle, s);
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "Settings loaded from NVS (%u bytes)", (unsigned)SETTINGS_PAYLOAD_LEN);
+    } else if (err == ESP_ERR_NVS_NOT_FOUND && has_legacy_keys(handle)) {
+        load_legacy_keys(handle, s);
+        err = write_settings_blob(handle, s);
+        if (err == ESP_OK) {
+            erase_legacy_keys(handle);
+            nvs_commit(handle);
+            ESP_LOGI(TAG, "Migrated per-key settings to settings blob");
+        } else {
+            ESP_LOGE(TAG, "Settings migration failed: %s", esp_err_to_name(err));
+        }
+    } else if (err == ESP_ERR_NVS_NOT_FOUND) {
+        ESP_LOGI(TAG, "No saved settings, using defaults");
+    } else {
+        // Keep the defaults; the next save replaces the bad blob.
+        ESP_LOGE(TAG, "Stored settings unusable (%s), using defaults", esp_err_to_name(err));
+    }
 
-        snprintf(key, sizeof(key), "msg%d_text", i);
-        nvs_set_str(handle, key, current_settings.messages[i].text);
+    if (s->rss_refresh_budget_s < SETTINGS_MIN_REFRESH_BUDGET_S ||
+        s->rss_refresh_budget_s > SETTINGS_MAX_REFRESH_BUDGET_S) {
+        s->rss_refresh_budget_s = 30;
+    }
+    rebuild_rss_sources(s);
 
-        snprintf(key, sizeof(key), "msg%d_r", i);
-        nvs_set_u8(handle, key, current_settings.messages[i].color_r);
+    nvs_close(handle);
+}
 
-        snprintf(key, sizeof(key), "msg%d_g", i);
-        nvs_set_u8(handle, key, current_settings.messages[i].color_g);
+// Write s unless flash already holds the same payload. Caller holds settings_mutex.
+static esp_err_t persist_settings(const app_settings_t *s)
+{
+    if (stored_valid && payload_crc(s) == stored_crc) {
+        ESP_LOGI(TAG, "Settings unchanged, skipping NVS write");
+        return ESP_OK;
+    }
 
-        snprintf(key, sizeof(key), "msg%d_b", i);
-        nvs_set_u8(handle, key, current_settings.messages[i].color_b);
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to open NVS: %s", esp_err_to_name(err));
+        return err;
+    }
 
-        snprintf(key, sizeof(key), "msg%d_en", i);
-        nvs_set_u8(handle, key, current_settings.messages[i].enabled ? 1 : 0);
-    }
-
-    nvs_set_u8(handle, "speed", current_settings.speed);
-    nvs_set_u8(handle, "bright", current_settings.brightness);
-    nvs_set_u8(handle, "panel_cols", current_settings.panel_cols);
-    nvs_set_str(handle, "wifi_ssid", current_settings.wifi_ssid);
-    nvs_set_str(handle, "wifi_pass", current_settings.wifi_password);
-    nvs_set_u8(handle, "rss_en", current_settings.rss_enabled ? 1 : 0);
-    nvs_set_u8(handle, "rss_npr_en", current_settings.rss_npr_enabled ? 1 : 0);
-    nvs_set_u8(handle, "rss_sports_en", current_settings.rss_sports_enabled ? 1 : 0);
-    nvs_set_str(handle, "rss_sports_base", current_settings.rss_sports_base_url);
-    nvs_set_u8(handle, "rss_mlb_en", current_settings.rss_sport_mlb_enabled ? 1 : 0);
-    nvs_set_u8(handle, "rss_nhl_en", current_settings.rss_sport_nhl_enabled ? 1 : 0);
-    nvs_set_u8(handle, "rss_ncaaf_en", current_settings.rss_sport_ncaaf_enabled ? 1 : 0);
-    nvs_set_u8(handle, "rss_nfl_en", current_settings.rss_sport_nfl_enabled ? 1 : 0);
-    nvs_set_u8(handle, "rss_nba_en", current_settings.rss_sport_nba_enabled ? 1 : 0);
-    nvs_set_u8(handle, "rss_big10_en", current_settings.rss_sport_big10_enabled ? 1 : 0);
-    esp_err_t url_err = nvs_set_str(handle, "rss_url", current_settings.rss_url);
-    if (url_err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to save rss_url: %s", esp_err_to_name(url_err));
-    }
-    nvs_set_u8(handle, "rss_count", current_settings.rss_source_count);
-    for (int i = 0; i < current_settings.rss_source_count; i++) {
-        char key[20];
-
-        snprintf(key, sizeof(key), "rs%d_en", i);
-        nvs_set_u8(handle, key, current_settings.rss_sources[i].enabled ? 1 : 0);
-
-        snprintf(key, sizeof(key), "rs%d_name", i);
-        nvs_set_str(handle, key, current_settings.rss_sources[i].name);
-
-        snprintf(key, sizeof(key), "rs%d_url", i);
-        nvs_set_str(handle, key, current_settings.rss_sources[i].url);
-    }
-
-    err = nvs_commit(handle);
+    err = write_settings_blob(handle, s);
     nvs_close(handle);
 
     if (err == ESP_OK) {
         ESP_LOGI(TAG, "Settings saved to NVS");
     } else {
-        ESP_LOGE(TAG, "Failed to commit NVS: %s", esp_err_to_name(err));
+        ESP_LOGE(TAG, "Failed to save settings: %s", esp_err_to_name(err));
+    }
+    return err;
+}
+
+// Waits for the first change, then for SETTINGS_FLUSH_DELAY_MS without
+// another one, so a slider drag costs one write instead of one per step.
+static void settings_flush_task(void *arg)
+{
+    (void)arg;
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SETTINGS_FLUSH_DELAY_MS)) > 0) {
+        }
+        settings_flush();
+    }
+}
+
+static void mark_dirty(uint32_t fields)
+{
+    if (fields == 0) return;
+
+    xSemaphoreTake(settings_mutex, portMAX_DELAY);
+    dirty_fields |= fields;
+    xSemaphoreGive(settings_mutex);
+
+    if (flush_task_handle) {
+        xTaskNotifyGive(flush_task_handle);
+    } else {
+        settings_flush();
+    }
+}
+
+// Claim a free pool slot for a draft. A slot is free once no reader holds
+// its snapshot; while readers still hold every old one, wait for a release.
+static settings_slot_t *claim_slot(void)
+{
+    for (int attempt = 0; attempt < SETTINGS_CLAIM_ATTEMPTS; attempt++) {
+        for (int i = 0; i < SETTINGS_SNAPSHOT_COUNT; i++) {
+            int expected = 0;
+            if (atomic_compare_exchange_strong(&slots[i].refs, &expected, 1)) {
+                return &slots[i];
+            }
+        }
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    return NULL;
+}
+
+esp_err_t settings_init(void)
+{
+    settings_mutex = xSemaphoreCreateMutex();
+    edit_mutex = xSemaphoreCreateMutex();
+    if (!settings_mutex || !edit_mutex) return ESP_ERR_NO_MEM;
+
+    settings_slot_t *slot = &slots[0];
+    atomic_store(&slot->refs, 1);
+    load_from_nvs(&slot->data);
+    atomic_store(&published, slot);
+    atomic_store(&generation, 1);
+
+    if (xTaskCreate(settings_flush_task, "settings_flush", 3072, NULL, 2,
+                    &flush_task_handle) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to start settings flush task");
+        flush_task_handle = NULL;
+    }
+    return ESP_OK;
+}
+
+const app_settings_t *settings_acquire(void)
+{
+    while (1) {
+        settings_slot_t *slot = atomic_load(&published);
+        atomic_fetch_add(&slot->refs, 1);
+        // The slot may have been replaced (and even reclaimed) in between;
+        // only keep the reference if it is still the published snapshot.
+        if (atomic_load(&published) == slot) {
+            return &slot->data;
+        }
+        atomic_fetch_sub(&slot->refs, 1);
+    }
+}
+
+void settings_release(const app_settings_t *s)
+{
+    if (!s) return;
+    settings_slot_t *slot = (settings_slot_t *)s;
+    atomic_fetch_sub(&slot->refs, 1);
+}
+
+uint32_t settings_get_generation(void)
+{
+    return atomic_load(&generation);
+}
+
+app_settings_t *settings_edit_begin(void)
+{
+    xSemaphoreTake(edit_mutex, portMAX_DELAY);
+    settings_slot_t *slot = claim_slot();
+    if (!slot) {
+        xSemaphoreGive(edit_mutex);
+        ESP_LOGE(TAG, "No free settings snapshot; edit dropped");
+        return NULL;
+    }
+
+    const app_settings_t *current = settings_acquire();
+    memcpy(&slot->data, current, sizeof(slot->data));
+    settings_release(current);
+    return &slot->data;
+}
+
+void settings_edit_commit(app_settings_t *draft, uint32_t fields)
+{
+    if (!draft) return;
+    settings_slot_t *slot = (settings_slot_t *)draft;
+
+    if (fields & SETTINGS_FIELD_RSS) {
+        rebuild_rss_sources(draft);
+    }
+
+    // The draft's claim becomes the published reference; the old snapshot
+    // drops its published reference and is freed once its readers release.
+    settings_slot_t *old = atomic_exchange(&published, slot);
+    atomic_fetch_add(&generation, 1);
+    atomic_fetch_sub(&old->refs, 1);
+
+    // Hold the new snapshot for the callbacks even if another edit replaces it.
+    atomic_fetch_add(&slot->refs, 1);
+    int count = subscriber_count;
+    settings_subscriber_t subs[SETTINGS_MAX_SUBSCRIBERS];
+    memcpy(subs, subscribers, sizeof(subs));
+    xSemaphoreGive(edit_mutex);
+
+    mark_dirty(fields);
+    for (int i = 0; i < count; i++) {
+        subs[i].cb(draft, fields, subs[i].ctx);
+    }
+    settings_release(draft);
+}
+
+void settings_edit_abort(app_settings_t *draft)
+{
+    if (!draft) return;
+    settings_release(draft);
+    xSemaphoreGive(edit_mutex);
+}
+
+esp_err_t settings_subscribe(settings_change_cb_t cb, void *ctx)
+{
+    if (!cb) return ESP_ERR_INVALID_ARG;
+
+    xSemaphoreTake(edit_mutex, portMAX_DELAY);
+    esp_err_t err = ESP_ERR_NO_MEM;
+    if (subscriber_count < SETTINGS_MAX_SUBSCRIBERS) {
+        subscribers[subscriber_count].cb = cb;
+        subscribers[subscriber_count].ctx = ctx;
+        subscriber_count++;
+        err = ESP_OK;
+    }
+    xSemaphoreGive(edit_mutex);
+    return err;
+}
+
+esp_err_t settings_flush(void)
+{
+    xSemaphoreTake(settings_mutex, portMAX_DELAY);
+    uint32_t fields = dirty_fields;
+    esp_err_t err = ESP_OK;
+    if (fields != 0) {
+        const app_settings_t *s = settings_acquire();
+        err = persist_settings(s);
+        settings_release(s);
+        if (err == ESP_OK) {
+            dirty_fields = 0;
+            ESP_LOGI(TAG, "Flushed settings (fields 0x%02x)", (unsigned)fields);
+        }
     }
+    xSemaphoreGive(settings_mutex);
     return err;
 }
 
-app_settings_t *settings_get(void)
+uint32_t settings_get_dirty(void)
 {
-    return &current_settings;
+    xSemaphoreTake(settings_mutex, portMAX_DELAY);
+    uint32_t fields = dirty_fields;
+    xSemaphoreGive(settings_mutex);
+    return fields;
 }
@@ -5,6 +5,7 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
 #include "esp_log.h"
+#include "deferred_log.h"
 
 static const char *TAG = "scroller";
 
@@ -116,7 +117,8 @@ void scroller_set_text(const char *text)
     scroll_x = strlen(current_text) * (FONT_WIDTH + 1);
     scroll_phase_q8 = 0;
     xSemaphoreGive(scroller_mutex);
-    ESP_LOGI(TAG, "Text set to: %s", current_text);
+    // Called from the display loop; never wait on the console here.
+    DLOGI_STR(TAG, "Text set to: %s", text);
 }
 
 void scroller_set_color(uint8_t r, uint8_t g, uint8_t b)
@@ -0,0 +1,140 @@
+#include "trace.h"
+#include <string.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "json_writer.h"
+
+typedef struct {
+    atomic_uint seq;     // index + 1 once the slot is written; 0 while writing
+    int64_t ts_us;
+    const char *name;
+    int32_t arg;
+    char phase;          // 'B', 'E' or 'i'
+    uint8_t core;
+} trace_event_t;
+
+typedef struct {
+    trace_event_t *events;
+    uint32_t mask;
+    atomic_uint head;
+} trace_ring_t;
+
+static trace_event_t refresh_events[TRACE_REFRESH_EVENTS];
+static trace_event_t render_events[TRACE_RENDER_EVENTS];
+
+static trace_ring_t rings[TRACE_CAT_COUNT] = {
+    [TRACE_CAT_REFRESH] = {.events = refresh_events, .mask = TRACE_REFRESH_EVENTS - 1},
+    [TRACE_CAT_RENDER]  = {.events = render_events,  .mask = TRACE_RENDER_EVENTS - 1},
+};
+
+static const char *const cat_names[TRACE_CAT_COUNT] = {"refresh", "render"};
+
+static void record(trace_cat_t cat, char phase, const char *name, int32_t arg)
+{
+    if (cat >= TRACE_CAT_COUNT) return;
+    trace_ring_t *ring = &rings[cat];
+
+    uint32_t index = atomic_fetch_add_explicit(&ring->head, 1, memory_order_relaxed);
+    trace_event_t *ev = &ring->events[index & ring->mask];
+    atomic_store_explicit(&ev->seq, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    ev->ts_us = esp_timer_get_time();
+    ev->name = name;
+    ev->arg = arg;
+    ev->phase = phase;
+    ev->core = (uint8_t)xPortGetCoreID();
+    atomic_store_explicit(&ev->seq, index + 1, memory_order_release);
+}
+
+void trace_begin(trace_cat_t cat, const char *name, int32_t arg)
+{
+    record(cat, 'B', name, arg);
+}
+
+void trace_end(trace_cat_t cat, const char *name, int32_t arg)
+{
+    record(cat, 'E', name, arg);
+}
+
+void trace_instant(trace_cat_t cat, const char *name, int32_t arg)
+{
+    record(cat, 'i', name, arg);
+}
+
+// Copy slot index out of the ring. False if it was overwritten (or is
+// being written) while we looked.
+static bool read_event(const trace_ring_t *ring, uint32_t index, trace_event_t *out)
+{
+    const trace_event_t *ev = &ring->events[index & ring->mask];
+    if (atomic_load_explicit(&ev->seq, memory_order_acquire) != index + 1) return false;
+    out->ts_us = ev->ts_us;
+    out->name = ev->name;
+    out->arg = ev->arg;
+    out->phase = ev->phase;
+    out->core = ev->core;
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&ev->seq, memory_order_relaxed) == index + 1;
+}
+
+static void write_thread_name(json_writer_t *w, int core, const char *name)
+{
+    json_writer_object_start(w);
+    json_writer_kv_string(w, "name", "thread_name");
+    json_writer_kv_string(w, "ph", "M");
+    json_writer_kv_int(w, "pid", 1);
+    json_writer_kv_int(w, "tid", core);
+    json_writer_key(w, "args");
+    json_writer_object_start(w);
+    json_writer_kv_string(w, "name", name);
+    json_writer_object_end(w);
+    json_writer_object_end(w);
+}
+
+static void write_ring(json_writer_t *w, trace_cat_t cat)
+{
+    const trace_ring_t *ring = &rings[cat];
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint32_t size = ring->mask + 1;
+    uint32_t first = head > size ? head - size : 0;
+
+    for (uint32_t index = first; index != head; index++) {
+        trace_event_t ev;
+        if (!read_event(ring, index, &ev)) continue;
+
+        char phase[2] = {ev.phase, '\0'};
+        json_writer_object_start(w);
+        json_writer_kv_string(w, "name", ev.name);
+        json_writer_kv_string(w, "cat", cat_names[cat]);
+        json_writer_kv_string(w, "ph", phase);
+        json_writer_kv_int(w, "ts", ev.ts_us);
+        json_writer_kv_int(w, "pid", 1);
+        json_writer_kv_int(w, "tid", ev.core);
+        if (ev.phase == 'i') json_writer_kv_string(w, "s", "t");
+        json_writer_key(w, "args");
+        json_writer_object_start(w);
+        json_writer_kv_int(w, "value", ev.arg);
+        json_writer_object_end(w);
+        json_writer_object_end(w);
+    }
+}
+
+bool trace_export(char *buf, size_t size, trace_flush_cb_t flush, void *ctx)
+{
+    json_writer_t w;
+    json_writer_init(&w, buf, size, flush, ctx);
+
+    json_writer_object_start(&w);
+    json_writer_kv_string(&w, "displayTimeUnit", "ms");
+    json_writer_key(&w, "traceEvents");
+    json_writer_array_start(&w);
+    write_thread_name(&w, 0, "core 0 (network)");
+    write_thread_name(&w, 1, "core 1 (display)");
+    for (int cat = 0; cat < TRACE_CAT_COUNT; cat++) {
+        write_ring(&w, (trace_cat_t)cat);
+    }
+    json_writer_array_end(&w);
+    json_writer_object_end(&w);
+    return json_writer_finish(&w);
+}
@@ -1,24 +1,95 @@
 #include "web_server.h"
-#include "text_scroller.h"
 #include "settings.h"
 #include "wifi_manager.h"
 #include "led_panel.h"
 #include "storage_paths.h"
+#include "rss_cache.h"
+#include "rss_scheduler.h"
+#include "boot_profile.h"
+#include "web_worker.h"
+#include "json_writer.h"
+#include "json_stream.h"
+#include "frame_stream.h"
+#include "realtime_ingest.h"
+#include "metrics.h"
+#include "trace.h"
+#include "deferred_log.h"
 #include <string.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "esp_http_server.h"
+#include "esp_netif.h"
 #include "esp_log.h"
-#include "nvs_flash.h"
-#include "esp_system.h"
-#include "cJSON.h"
 
 static const char *TAG = "web_server";
 static httpd_handle_t server = NULL;
 
+// Read the build-time content hash written next to path (see
+// scripts/pio_post.py) as a quoted ETag. False if the image has none.
+static bool read_etag(const char *path, char *etag, size_t etag_size)
+{
+    char etag_path[96];
+    snprintf(etag_path, sizeof(etag_path), "%s.etag", path);
+    FILE *fp = fopen(etag_path, "r");
+    if (!fp) return false;
+
+    char hash[33] = "";
+    size_t len = fread(hash, 1, sizeof(hash) - 1, fp);
+    fclose(fp);
+    while (len > 0 && (hash[len - 1] == '\n' || hash[len - 1] == '\r' || hash[len - 1] == ' ')) {
+        len--;
+    }
+    hash[len] = '\0';
+    if (len == 0) return false;
+
+    snprintf(etag, etag_size, "\"%s\"", hash);
+    return true;
+}
+
+static bool header_contains(httpd_req_t *req, const char *field, const char *needle)
+{
+    char value[128];
+    if (httpd_req_get_hdr_value_str(req, field, value, sizeof(value)) != ESP_OK) {
+        return false;
+    }
+    return strstr(value, needle) != NULL;
+}
+
+// Serve path from LittleFS. Uses the precompressed path.gz when the client
+// accepts gzip, and answers 304 when If-None-Match matches the ETag. The
+// URLs aren't versioned, so browsers must revalidate (no-cache) rather than
+// keep the page for a fixed time; a revalidation costs one small 304.
 static esp_err_t send_file_response(httpd_req_t *req, const char *path, const char *content_type)
 {
-    FILE *fp = fopen(path, "rb");
+    // Handlers run one at a time on the httpd task.
+    static char chunk[4096];
+
+    char etag[40];
+    bool have_etag = read_etag(path, etag, sizeof(etag));
+    if (have_etag) {
+        httpd_resp_set_hdr(req, "ETag", etag);
+        httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+        if (header_contains(req, "If-None-Match", etag)) {
+            httpd_resp_set_status(req, "304 Not Modified");
+            return httpd_resp_send(req, NULL, 0);
+        }
+    }
+
+    FILE *fp = NULL;
+    if (header_contains(req, "Accept-Encoding", "gzip")) {
+        char gz_path[96];
+        snprintf(gz_path, sizeof(gz_path), "%s.gz", path);
+        fp = fopen(gz_path, "rb");
+        if (fp) {
+            httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+        }
+    }
+    if (!fp) {
+        fp = fopen(path, "rb");
+    }
     if (!fp) {
         ESP_LOGW(TAG, "File not found: %s", path);
         httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "File not found");
@@ -26,8 +97,8 @@ static esp_err_t send_file_response(httpd_req_t *req, const char *path, const ch
     }
 
     httpd_resp_set_type(req, content_type);
+    httpd_resp_set_hdr(req, "Vary", "Accept-Encoding");
 
-    char chunk[1024];
     size_t read = 0;
     do {
         read = fread(chunk, 1, sizeof(chunk), fp);
@@ -48,10 +119,43 @@ static esp_err_t root_handler(httpd_req_t *req)
     return send_file_response(req, LITTLEFS_WEB_INDEX_PATH, "text/html");
 }
 
-// GET /api/status — return current settings as JSON
+// Cache metadata and scheduler health for one source in /api/status.
+static void write_source_health(json_writer_t *w, const char *url, TickType_t now)
+{
+    rss_cache_source_info_t info = {0};
+    bool cached = rss_cache_get_source_info(url, &info) == ESP_OK;
+    json_writer_kv_int(w, "cached_items", cached ? info.item_count : 0);
+    json_writer_kv_int(w, "live_items", cached ? info.live_count : 0);
+    json_writer_kv_int(w, "updated_epoch", cached ? info.updated_epoch : 0);
+
+    rss_source_health_t health;
+    const char *state = "idle";
+    if (rss_scheduler_get_health(url, now, &health)) {
+        if (health.consecutive_failures > 0) {
+            state = "failing";
+        } else if (health.fetched) {
+            state = "ok";
+        } else {
+            state = "pending";
+        }
+        json_writer_kv_int(w, "failures", health.consecutive_failures);
+        json_writer_kv_string(w, "last_error",
+                              health.last_error == ESP_OK ? "" : esp_err_to_name(health.last_error));
+        json_writer_kv_int(w, "interval_s", health.interval_ms / 1000);
+        json_writer_kv_int(w, "next_attempt_s", health.next_attempt_ms / 1000);
+    }
+    json_writer_kv_string(w, "state", state);
+}
+
+static bool send_chunk_cb(void *ctx, const char *data, size_t len)
+{
+    return httpd_resp_send_chunk((httpd_req_t *)ctx, data, len) == ESP_OK;
+}
+
+// GET /api/status — return current settings as JSON, streamed in chunks
+// from a stack buffer so polling never touches the heap.
 static esp_err_t status_handler(httpd_req_t *req)
 {
-    app_settings_t *s = settings_get();
     const char *mode_str;
     switch (wifi_manager_get_mode()) {
     case WIFI_MGR_MODE_AP:             mode_str = "AP"; break;
@@ -60,74 +164,216 @@ static esp_err_t status_handler(httpd_req_t *req)
     default:                           mode_str = "None"; break;
     }
 
-    cJSON *root = cJSON_CreateObject();
+    char buf[512];
+    json_writer_t w;
+    json_writer_init(&w, buf, sizeof(buf), send_chunk_cb, req);
+    httpd_resp_set_type(req, "application/json");
+
+    const app_settings_t *s = settings_acquire();
+    json_writer_object_start(&w);
 
-    cJSON *msgs = cJSON_AddArrayToObject(root, "messages");
+    json_writer_key(&w, "messages");
+    json_writer_array_start(&w);
     for (int i = 0; i < MAX_MESSAGES; i++) {
-        cJSON *m = cJSON_CreateObject();
-        cJSON_AddStringToObject(m, "text", s->messages[i].text);
-        cJSON_AddNumberToObject(m, "r", s->messages[i].color_r);
-        cJSON_AddNumberToObject(m, "g", s->messages[i].color_g);
-        cJSON_AddNumberToObject(m, "b", s->messages[i].color_b);
-        cJSON_AddBoolToObject(m, "enabled", s->messages[i].enabled);
-        cJSON_AddItemToArray(msgs, m);
-    }
-
-    cJSON_AddNumberToObject(root, "speed", s->speed);
-    cJSON_AddNumberToObject(root, "brightness", s->brightness);
-    cJSON_AddStringToObject(root, "wifi_mode", mode_str);
-    cJSON_AddStringToObject(root, "ip", wifi_manager_get_ip());
-    cJSON_AddNumberToObject(root, "panel_cols", s->panel_cols);
-    cJSON_AddStringToObject(root, "wifi_ssid", s->wifi_ssid);
-    cJSON_AddStringToObject(root, "wifi_password", s->wifi_password);
-    cJSON_AddBoolToObject(root, "rss_enabled", s->rss_enabled);
-    cJSON_AddStringToObject(root, "rss_url", s->rss_url);
-    cJSON_AddBoolToObject(root, "rss_npr_enabled", s->rss_npr_enabled);
-    cJSON_AddBoolToObject(root, "rss_sports_enabled", s->rss_sports_enabled);
-    cJSON_AddStringToObject(root, "rss_sports_base_url", s->rss_sports_base_url);
-    cJSON *rss_sports = cJSON_AddObjectToObject(root, "rss_sports");
-    cJSON_AddBoolToObject(rss_sports, "mlb", s->rss_sport_mlb_enabled);
-    cJSON_AddBoolToObject(rss_sports, "nhl", s->rss_sport_nhl_enabled);
-    cJSON_AddBoolToObject(rss_sports, "ncaaf", s->rss_sport_ncaaf_enabled);
-    cJSON_AddBoolToObject(rss_sports, "nfl", s->rss_sport_nfl_enabled);
-    cJSON_AddBoolToObject(rss_sports, "nba", s->rss_sport_nba_enabled);
-    cJSON_AddBoolToObject(rss_sports, "big10", s->rss_sport_big10_enabled);
-    cJSON_AddNumberToObject(root, "rss_source_count", s->rss_source_count);
-    cJSON *rss_sources = cJSON_AddArrayToObject(root, "rss_sources");
+        json_writer_object_start(&w);
+        json_writer_kv_string(&w, "text", s->messages[i].text);
+        json_writer_kv_int(&w, "r", s->messages[i].color_r);
+        json_writer_kv_int(&w, "g", s->messages[i].color_g);
+        json_writer_kv_int(&w, "b", s->messages[i].color_b);
+        json_writer_kv_bool(&w, "enabled", s->messages[i].enabled);
+        json_writer_object_end(&w);
+    }
+    json_writer_array_end(&w);
+
+    json_writer_kv_int(&w, "speed", s->speed);
+    json_writer_kv_int(&w, "brightness", s->brightness);
+    json_writer_kv_string(&w, "wifi_mode", mode_str);
+    json_writer_kv_string(&w, "ip", wifi_manager_get_ip());
+    json_writer_kv_int(&w, "panel_cols", s->panel_cols);
+    json_writer_kv_int(&w, "refresh_budget_s", s->rss_refresh_budget_s);
+    json_writer_kv_bool(&w, "background_refresh", s->rss_background_refresh);
+    json_writer_kv_string(&w, "wifi_ssid", s->wifi_ssid);
+    // The password itself is never sent back.
+    json_writer_kv_bool(&w, "wifi_password_set", s->wifi_password[0] != '\0');
+    json_writer_key(&w, "wifi_static_ip");
+    json_writer_object_start(&w);
+    json_writer_kv_bool(&w, "enabled", s->wifi_static_enabled);
+    json_writer_kv_string(&w, "ip", s->wifi_static_ip);
+    json_writer_kv_string(&w, "gateway", s->wifi_static_gateway);
+    json_writer_kv_string(&w, "netmask", s->wifi_static_netmask);
+    json_writer_kv_string(&w, "dns", s->wifi_static_dns);
+    json_writer_object_end(&w);
+
+    wifi_reconnect_stats_t rs;
+    wifi_manager_get_reconnect_stats(&rs);
+    json_writer_key(&w, "wifi_reconnect");
+    json_writer_object_start(&w);
+    json_writer_kv_int(&w, "count", rs.count);
+    json_writer_kv_int(&w, "fast_path_count", rs.fast_path_count);
+    json_writer_kv_int(&w, "failures", rs.failures);
+    json_writer_kv_int(&w, "last_ms", rs.last_ms);
+    json_writer_kv_int(&w, "min_ms", rs.min_ms);
+    json_writer_kv_int(&w, "max_ms", rs.max_ms);
+    json_writer_kv_int(&w, "avg_ms", rs.count ? rs.total_ms / rs.count : 0);
+    json_writer_object_end(&w);
+
+    led_panel_stats_t ps;
+    led_panel_get_stats(&ps);
+    json_writer_key(&w, "display");
+    json_writer_object_start(&w);
+    json_writer_kv_int(&w, "frames", ps.refresh_count);
+    json_writer_kv_int(&w, "slow_refreshes", ps.slow_refreshes);
+    json_writer_kv_int(&w, "max_refresh_us", ps.max_refresh_us);
+    json_writer_kv_int(&w, "stalls", ps.stalls);
+    json_writer_kv_int(&w, "max_gap_ms", ps.max_gap_ms);
+    json_writer_object_end(&w);
+
+    realtime_ingest_stats_t rt;
+    realtime_ingest_get_stats(&rt);
+    json_writer_key(&w, "realtime");
+    json_writer_object_start(&w);
+    json_writer_kv_bool(&w, "active", realtime_ingest_active());
+    json_writer_kv_int(&w, "packets", rt.packets);
+    json_writer_kv_int(&w, "frames", rt.frames);
+    json_writer_kv_int(&w, "frames_torn", rt.frames_torn);
+    json_writer_kv_int(&w, "frames_skipped", rt.frames_skipped);
+    json_writer_kv_int(&w, "packets_late", rt.packets_late);
+    json_writer_kv_int(&w, "packets_invalid", rt.packets_invalid);
+    json_writer_object_end(&w);
+
+    json_writer_key(&w, "boot_ms");
+    json_writer_object_start(&w);
+    for (int i = 0; i < BOOT_STAGE_COUNT; i++) {
+        int32_t ms = boot_profile_get_ms((boot_stage_t)i);
+        if (ms >= 0) {
+            json_writer_kv_int(&w, boot_profile_stage_name((boot_stage_t)i), ms);
+        }
+    }
+    json_writer_object_end(&w);
+
+    json_writer_kv_bool(&w, "rss_enabled", s->rss_enabled);
+    json_writer_kv_string(&w, "rss_url", s->rss_url);
+    json_writer_kv_bool(&w, "rss_npr_enabled", s->rss_npr_enabled);
+    json_writer_kv_bool(&w, "rss_sports_enabled", s->rss_sports_enabled);
+    json_writer_kv_string(&w, "rss_sports_base_url", s->rss_sports_base_url);
+    json_writer_key(&w, "rss_sports");
+    json_writer_object_start(&w);
+    json_writer_kv_bool(&w, "mlb", s->rss_sport_mlb_enabled);
+    json_writer_kv_bool(&w, "nhl", s->rss_sport_nhl_enabled);
+    json_writer_kv_bool(&w, "ncaaf", s->rss_sport_ncaaf_enabled);
+    json_writer_kv_bool(&w, "nfl", s->rss_sport_nfl_enabled);
+    json_writer_kv_bool(&w, "nba", s->rss_sport_nba_enabled);
+    json_writer_kv_bool(&w, "big10", s->rss_sport_big10_enabled);
+    json_writer_object_end(&w);
+    json_writer_key(&w, "rss_json");
+    json_writer_object_start(&w);
+    json_writer_kv_bool(&w, "enabled", s->rss_json_enabled);
+    json_writer_kv_string(&w, "name", s->rss_json_name);
+    json_writer_kv_string(&w, "url", s->rss_json_url);
+    json_writer_kv_string(&w, "title_path", s->rss_json_title_path);
+    json_writer_kv_string(&w, "desc_path", s->rss_json_desc_path);
+    json_writer_object_end(&w);
+
+    json_writer_kv_int(&w, "rss_source_count", s->rss_source_count);
+    json_writer_key(&w, "rss_sources");
+    json_writer_array_start(&w);
+    TickType_t now = xTaskGetTickCount();
     int source_count = s->rss_source_count;
     if (source_count > MAX_RSS_SOURCES) source_count = MAX_RSS_SOURCES;
     for (int i = 0; i < source_count; i++) {
-        cJSON *src = cJSON_CreateObject();
-        cJSON_AddStringToObject(src, "name", s->rss_sources[i].name);
-        cJSON_AddBoolToObject(src, "enabled", s->rss_sources[i].enabled);
-        cJSON_AddStringToObject(src, "url", s->rss_sources[i].url);
-        cJSON_AddItemToArray(rss_sources, src);
+        const rss_source_t *src = &s->rss_sources[i];
+        json_writer_object_start(&w);
+        json_writer_kv_string(&w, "name", src->name);
+        json_writer_kv_bool(&w, "enabled", src->enabled);
+        json_writer_kv_string(&w, "url", src->url);
+        json_writer_kv_string(&w, "type", src->type == RSS_SOURCE_TYPE_JSON ? "json" : "rss");
+        if (src->type == RSS_SOURCE_TYPE_JSON) {
+            json_writer_kv_string(&w, "title_path", src->json_title_path);
+            json_writer_kv_string(&w, "desc_path", src->json_desc_path);
+        }
+        write_source_health(&w, src->url, now);
+        json_writer_object_end(&w);
     }
+    json_writer_array_end(&w);
 
-    char *json = cJSON_PrintUnformatted(root);
-    httpd_resp_set_type(req, "application/json");
-    httpd_resp_send(req, json, strlen(json));
-    cJSON_free(json);
-    cJSON_Delete(root);
-    return ESP_OK;
+    json_writer_object_end(&w);
+    settings_release(s);
+
+    if (!json_writer_finish(&w)) {
+        ESP_LOGW(TAG, "Status response aborted");
+        httpd_resp_sendstr_chunk(req, NULL);
+        return ESP_FAIL;
+    }
+    return httpd_resp_send_chunk(req, NULL, 0);
 }
 
-// Helper: read POST body and parse as JSON
-static cJSON *read_json_body(httpd_req_t *req)
+// POST bodies are parsed while they are received, never held whole.
+#define WEB_MAX_BODY_LEN   (16 * 1024)
+#define WEB_BODY_CHUNK_LEN 512
+
+// Parse state shared by the body callbacks. Handlers embed this in a
+// request struct that the callbacks fill; the settings edit starts only
+// once the whole body has arrived and parsed, so a slow client never holds
+// the edit lock or a snapshot slot.
+typedef struct {
+    const json_stream_t *js;
+    uint32_t seen;      // handler-specific BODY_* flags for required fields
+} body_ctx_t;
+
+// Receive timeouts tolerated per body before answering 408.
+#define WEB_BODY_MAX_TIMEOUTS 3
+
+// Receive the body in chunks and feed each one to a streaming JSON parser
+// that calls cb for every token. Memory stays fixed whatever the body size.
+static esp_err_t parse_json_body(httpd_req_t *req, json_stream_cb_t cb, body_ctx_t *ctx)
 {
-    int total_len = req->content_len;
-    if (total_len <= 0 || total_len > 4096) return NULL;
+    // Handlers run one at a time on the httpd task.
+    static json_stream_t parser;
+    static char chunk[WEB_BODY_CHUNK_LEN];
+
+    size_t remaining = req->content_len;
+    if (remaining == 0) return ESP_ERR_INVALID_ARG;
+    if (remaining > WEB_MAX_BODY_LEN) return ESP_ERR_INVALID_SIZE;
+
+    json_stream_init(&parser, cb, ctx);
+    ctx->js = &parser;
+
+    int timeouts = 0;
+    while (remaining > 0) {
+        size_t want = remaining < sizeof(chunk) ? remaining : sizeof(chunk);
+        int received = httpd_req_recv(req, chunk, want);
+        if (received == HTTPD_SOCK_ERR_TIMEOUT) {
+            if (++timeouts >= WEB_BODY_MAX_TIMEOUTS) return ESP_ERR_TIMEOUT;
+            continue;
+        }
+        if (received <= 0) return ESP_FAIL;
+        remaining -= received;
 
-    char *buf = malloc(total_len + 1);
-    if (!buf) return NULL;
+        if (json_stream_feed(&parser, chunk, received) != JSON_STREAM_OK) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    return json_stream_finish(&parser) == JSON_STREAM_OK ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
 
-    int received = httpd_req_recv(req, buf, total_len);
-    if (received <= 0) { free(buf); return NULL; }
-    buf[received] = '\0';
+static const char *body_error_message(esp_err_t err)
+{
+    switch (err) {
+    case ESP_ERR_INVALID_SIZE: return "Request body too large";
+    case ESP_FAIL:             return "Request body incomplete";
+    default:                   return "Invalid JSON";
+    }
+}
 
-    cJSON *json = cJSON_Parse(buf);
-    free(buf);
-    return json;
+static bool is_bool_event(json_stream_event_t event)
+{
+    return event == JSON_STREAM_TRUE || event == JSON_STREAM_FALSE;
+}
+
+static void copy_string(char *dst, size_t max_len, const char *value)
+{
+    strncpy(dst, value, max_len);
+    dst[max_len] = '\0';
 }
 
 static void send_ok(httpd_req_t *req, const char *msg)
@@ -138,6 +384,23 @@ static void send_ok(httpd_req_t *req, const char *msg)
     httpd_resp_send(req, resp, strlen(resp));
 }
 
+// 202 with the operation ID to poll at /api/op; 503 if the worker queue is full.
+static void send_accepted(httpd_req_t *req, const char *msg, uint32_t op_id)
+{
+    if (op_id == 0) {
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        httpd_resp_set_type(req, "application/json");
+        httpd_resp_sendstr(req, "{\"error\":\"Busy, try again\"}");
+        return;
+    }
+
+    char resp[128];
+    snprintf(resp, sizeof(resp), "{\"status\":\"%s\",\"op\":%u}", msg, (unsigned)op_id);
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_status(req, "202 Accepted");
+    httpd_resp_send(req, resp, strlen(resp));
+}
+
 static void send_err(httpd_req_t *req, const char *msg)
 {
     char resp[128];
@@ -147,276 +410,526 @@ static void send_err(httpd_req_t *req, const char *msg)
     httpd_resp_send(req, resp, strlen(resp));
 }
 
-// POST /api/messages — update all messages
-static esp_err_t messages_handler(httpd_req_t *req)
+// Parse the body into ctx's request. On failure the error response is sent
+// and false returned: 408 if the client stalled, 400 otherwise.
+static bool parse_body_or_error(httpd_req_t *req, json_stream_cb_t cb, body_ctx_t *ctx)
 {
-    cJSON *json = read_json_body(req);
-    if (!json) { send_err(req, "Invalid JSON"); return ESP_OK; }
-
-    cJSON *msgs = cJSON_GetObjectItem(json, "messages");
-    if (!cJSON_IsArray(msgs)) {
-        cJSON_Delete(json);
-        send_err(req, "Missing 'messages' array");
-        return ESP_OK;
+    esp_err_t err = parse_json_body(req, cb, ctx);
+    if (err == ESP_ERR_TIMEOUT) {
+        httpd_resp_send_err(req, HTTPD_408_REQ_TIMEOUT, "Request body timed out");
+        return false;
+    }
+    if (err != ESP_OK) {
+        send_err(req, body_error_message(err));
+        return false;
     }
+    return true;
+}
 
-    app_settings_t *s = settings_get();
-    int count = cJSON_GetArraySize(msgs);
-    if (count > MAX_MESSAGES) count = MAX_MESSAGES;
+// Start a settings edit, answering "busy" if no snapshot slot is free.
+static app_settings_t *begin_edit_or_busy(httpd_req_t *req)
+{
+    app_settings_t *s = settings_edit_begin();
+    if (!s) send_err(req, "Settings busy, try again");
+    return s;
+}
 
-    for (int i = 0; i < count; i++) {
-        cJSON *m = cJSON_GetArrayItem(msgs, i);
-        if (!cJSON_IsObject(m)) continue;
+#define BODY_MESSAGES (1u << 0)
 
-        cJSON *text = cJSON_GetObjectItem(m, "text");
-        if (cJSON_IsString(text)) {
-            strncpy(s->messages[i].text, text->valuestring, SETTINGS_MAX_TEXT_LEN);
-            s->messages[i].text[SETTINGS_MAX_TEXT_LEN] = '\0';
-        }
+#define MESSAGE_FIELD_TEXT    (1u << 0)
+#define MESSAGE_FIELD_R       (1u << 1)
+#define MESSAGE_FIELD_G       (1u << 2)
+#define MESSAGE_FIELD_B       (1u << 3)
+#define MESSAGE_FIELD_ENABLED (1u << 4)
+
+typedef struct {
+    body_ctx_t base;
+    message_t messages[MAX_MESSAGES];
+    uint8_t fields[MAX_MESSAGES];  // MESSAGE_FIELD_* sent for each message
+} messages_request_t;
 
-        cJSON *r = cJSON_GetObjectItem(m, "r");
-        cJSON *g = cJSON_GetObjectItem(m, "g");
-        cJSON *b = cJSON_GetObjectItem(m, "b");
-        if (cJSON_IsNumber(r)) s->messages[i].color_r = (uint8_t)r->valueint;
-        if (cJSON_IsNumber(g)) s->messages[i].color_g = (uint8_t)g->valueint;
-        if (cJSON_IsNumber(b)) s->messages[i].color_b = (uint8_t)b->valueint;
+static bool messages_body_cb(void *arg, json_stream_event_t event, const char *path,
+                             const char *value, int value_len)
+{
+    messages_request_t *r = arg;
+    if (event == JSON_STREAM_ARRAY_START && strcmp(path, "messages") == 0) {
+        r->base.seen |= BODY_MESSAGES;
+        return true;
+    }
+    if (strncmp(path, "messages[].", 11) != 0) return true;
+
+    int i = json_stream_array_index(r->base.js);
+    if (i < 0 || i >= MAX_MESSAGES) return true;
+    message_t *m = &r->messages[i];
+    const char *field = path + 11;
+
+    if (event == JSON_STREAM_STRING && strcmp(field, "text") == 0) {
+        copy_string(m->text, SETTINGS_MAX_TEXT_LEN, value);
+        r->fields[i] |= MESSAGE_FIELD_TEXT;
+    } else if (event == JSON_STREAM_NUMBER && strcmp(field, "r") == 0) {
+        m->color_r = (uint8_t)atoi(value);
+        r->fields[i] |= MESSAGE_FIELD_R;
+    } else if (event == JSON_STREAM_NUMBER && strcmp(field, "g") == 0) {
+        m->color_g = (uint8_t)atoi(value);
+        r->fields[i] |= MESSAGE_FIELD_G;
+    } else if (event == JSON_STREAM_NUMBER && strcmp(field, "b") == 0) {
+        m->color_b = (uint8_t)atoi(value);
+        r->fields[i] |= MESSAGE_FIELD_B;
+    } else if (is_bool_event(event) && strcmp(field, "enabled") == 0) {
+        m->enabled = event == JSON_STREAM_TRUE;
+        r->fields[i] |= MESSAGE_FIELD_ENABLED;
+    }
+    return true;
+}
 
-        cJSON *en = cJSON_GetObjectItem(m, "enabled");
-        if (cJSON_IsBool(en)) s->messages[i].enabled = cJSON_IsTrue(en);
+// POST /api/messages — update all messages
+static esp_err_t messages_handler(httpd_req_t *req)
+{
+    // About 1 KB; handlers run one at a time on the httpd task.
+    static messages_request_t r;
+    memset(&r, 0, sizeof(r));
+    if (!parse_body_or_error(req, messages_body_cb, &r.base)) return ESP_OK;
+    if (!(r.base.seen & BODY_MESSAGES)) {
+        send_err(req, "Missing 'messages' array");
+        return ESP_OK;
     }
 
-    settings_save(s);
-    cJSON_Delete(json);
+    app_settings_t *s = begin_edit_or_busy(req);
+    if (!s) return ESP_OK;
+    for (int i = 0; i < MAX_MESSAGES; i++) {
+        const message_t *src = &r.messages[i];
+        message_t *m = &s->messages[i];
+        if (r.fields[i] & MESSAGE_FIELD_TEXT) strcpy(m->text, src->text);
+        if (r.fields[i] & MESSAGE_FIELD_R) m->color_r = src->color_r;
+        if (r.fields[i] & MESSAGE_FIELD_G) m->color_g = src->color_g;
+        if (r.fields[i] & MESSAGE_FIELD_B) m->color_b = src->color_b;
+        if (r.fields[i] & MESSAGE_FIELD_ENABLED) m->enabled = src->enabled;
+    }
+    settings_edit_commit(s, SETTINGS_FIELD_MESSAGES);
     send_ok(req, "Messages updated");
     return ESP_OK;
 }
 
+#define BODY_TEXT (1u << 0)
+
+typedef struct {
+    body_ctx_t base;
+    char text[SETTINGS_MAX_TEXT_LEN + 1];
+} text_request_t;
+
+static bool text_body_cb(void *arg, json_stream_event_t event, const char *path,
+                         const char *value, int value_len)
+{
+    text_request_t *r = arg;
+    if (event == JSON_STREAM_STRING && strcmp(path, "text") == 0) {
+        copy_string(r->text, SETTINGS_MAX_TEXT_LEN, value);
+        r->base.seen |= BODY_TEXT;
+    }
+    return true;
+}
+
 // POST /api/text — update message[0] text (legacy)
 static esp_err_t text_handler(httpd_req_t *req)
 {
-    cJSON *json = read_json_body(req);
-    if (!json) { send_err(req, "Invalid JSON"); return ESP_OK; }
-
-    cJSON *text = cJSON_GetObjectItem(json, "text");
-    if (!cJSON_IsString(text)) {
-        cJSON_Delete(json);
+    text_request_t r = {0};
+    if (!parse_body_or_error(req, text_body_cb, &r.base)) return ESP_OK;
+    if (!(r.base.seen & BODY_TEXT)) {
         send_err(req, "Missing 'text' field");
         return ESP_OK;
     }
 
-    app_settings_t *s = settings_get();
-    strncpy(s->messages[0].text, text->valuestring, SETTINGS_MAX_TEXT_LEN);
-    s->messages[0].text[SETTINGS_MAX_TEXT_LEN] = '\0';
+    app_settings_t *s = begin_edit_or_busy(req);
+    if (!s) return ESP_OK;
+    strcpy(s->messages[0].text, r.text);
     s->messages[0].enabled = true;
-    scroller_set_text(s->messages[0].text);
-    settings_save(s);
-
-    cJSON_Delete(json);
+    settings_edit_commit(s, SETTINGS_FIELD_MESSAGES);
     send_ok(req, "Text updated");
     return ESP_OK;
 }
 
+#define BODY_R (1u << 0)
+#define BODY_G (1u << 1)
+#define BODY_B (1u << 2)
+
+typedef struct {
+    body_ctx_t base;
+    uint8_t r, g, b;
+} color_request_t;
+
+static bool color_body_cb(void *arg, json_stream_event_t event, const char *path,
+                          const char *value, int value_len)
+{
+    color_request_t *c = arg;
+    if (event != JSON_STREAM_NUMBER) return true;
+
+    if (strcmp(path, "r") == 0) {
+        c->r = (uint8_t)atoi(value);
+        c->base.seen |= BODY_R;
+    } else if (strcmp(path, "g") == 0) {
+        c->g = (uint8_t)atoi(value);
+        c->base.seen |= BODY_G;
+    } else if (strcmp(path, "b") == 0) {
+        c->b = (uint8_t)atoi(value);
+        c->base.seen |= BODY_B;
+    }
+    return true;
+}
+
 // POST /api/color — update message[0] color (legacy)
 static esp_err_t color_handler(httpd_req_t *req)
 {
-    cJSON *json = read_json_body(req);
-    if (!json) { send_err(req, "Invalid JSON"); return ESP_OK; }
-
-    cJSON *r = cJSON_GetObjectItem(json, "r");
-    cJSON *g = cJSON_GetObjectItem(json, "g");
-    cJSON *b = cJSON_GetObjectItem(json, "b");
-    if (!cJSON_IsNumber(r) || !cJSON_IsNumber(g) || !cJSON_IsNumber(b)) {
-        cJSON_Delete(json);
+    color_request_t c = {0};
+    if (!parse_body_or_error(req, color_body_cb, &c.base)) return ESP_OK;
+    if (c.base.seen != (BODY_R | BODY_G | BODY_B)) {
         send_err(req, "Missing r/g/b fields");
         return ESP_OK;
     }
 
-    app_settings_t *s = settings_get();
-    s->messages[0].color_r = (uint8_t)r->valueint;
-    s->messages[0].color_g = (uint8_t)g->valueint;
-    s->messages[0].color_b = (uint8_t)b->valueint;
-    scroller_set_color(s->messages[0].color_r, s->messages[0].color_g, s->messages[0].color_b);
-    settings_save(s);
-
-    cJSON_Delete(json);
+    app_settings_t *s = begin_edit_or_busy(req);
+    if (!s) return ESP_OK;
+    s->messages[0].color_r = c.r;
+    s->messages[0].color_g = c.g;
+    s->messages[0].color_b = c.b;
+    settings_edit_commit(s, SETTINGS_FIELD_MESSAGES);
     send_ok(req, "Color updated");
     return ESP_OK;
 }
 
+#define BODY_SPEED      (1u << 0)
+#define BODY_BRIGHTNESS (1u << 1)
+
+typedef struct {
+    body_ctx_t base;
+    uint8_t speed;
+    uint8_t brightness;
+} appearance_request_t;
+
+// Shared by /api/speed, /api/brightness and /api/appearance.
+static bool appearance_body_cb(void *arg, json_stream_event_t event, const char *path,
+                               const char *value, int value_len)
+{
+    appearance_request_t *a = arg;
+    if (event != JSON_STREAM_NUMBER) return true;
+
+    if (strcmp(path, "speed") == 0) {
+        a->speed = (uint8_t)atoi(value);
+        a->base.seen |= BODY_SPEED;
+    } else if (strcmp(path, "brightness") == 0) {
+        a->brightness = (uint8_t)atoi(value);
+        a->base.seen |= BODY_BRIGHTNESS;
+    }
+    return true;
+}
+
+// Apply whichever of speed/brightness the body carried and commit.
+static bool apply_appearance(httpd_req_t *req, const appearance_request_t *a)
+{
+    app_settings_t *s = begin_edit_or_busy(req);
+    if (!s) return false;
+
+    uint32_t fields = 0;
+    if (a->base.seen & BODY_SPEED) {
+        s->speed = a->speed;
+        fields |= SETTINGS_FIELD_SPEED;
+    }
+    if (a->base.seen & BODY_BRIGHTNESS) {
+        s->brightness = a->brightness;
+        fields |= SETTINGS_FIELD_BRIGHTNESS;
+    }
+    settings_edit_commit(s, fields);
+    return true;
+}
+
 // POST /api/speed — update scroll speed
 static esp_err_t speed_handler(httpd_req_t *req)
 {
-    cJSON *json = read_json_body(req);
-    if (!json) { send_err(req, "Invalid JSON"); return ESP_OK; }
-
-    cJSON *speed = cJSON_GetObjectItem(json, "speed");
-    if (!cJSON_IsNumber(speed)) {
-        cJSON_Delete(json);
+    appearance_request_t a = {0};
+    if (!parse_body_or_error(req, appearance_body_cb, &a.base)) return ESP_OK;
+    if (!(a.base.seen & BODY_SPEED)) {
         send_err(req, "Missing 'speed' field");
         return ESP_OK;
     }
 
-    app_settings_t *s = settings_get();
-    s->speed = (uint8_t)speed->valueint;
-    scroller_set_speed(s->speed);
-    settings_save(s);
-
-    cJSON_Delete(json);
-    send_ok(req, "Speed updated");
+    if (apply_appearance(req, &a)) send_ok(req, "Speed updated");
     return ESP_OK;
 }
 
 // POST /api/brightness — update brightness
 static esp_err_t brightness_handler(httpd_req_t *req)
 {
-    cJSON *json = read_json_body(req);
-    if (!json) { send_err(req, "Invalid JSON"); return ESP_OK; }
-
-    cJSON *bright = cJSON_GetObjectItem(json, "brightness");
-    if (!cJSON_IsNumber(bright)) {
-        cJSON_Delete(json);
+    appearance_request_t a = {0};
+    if (!parse_body_or_error(req, appearance_body_cb, &a.base)) return ESP_OK;
+    if (!(a.base.seen & BODY_BRIGHTNESS)) {
         send_err(req, "Missing 'brightness' field");
         return ESP_OK;
     }
 
-    app_settings_t *s = settings_get();
-    s->brightness = (uint8_t)bright->valueint;
-    led_panel_set_brightness(s->brightness);
-    settings_save(s);
-
-    cJSON_Delete(json);
-    send_ok(req, "Brightness updated");
+    if (apply_appearance(req, &a)) send_ok(req, "Brightness updated");
     return ESP_OK;
 }
 
+#define BODY_SSID        (1u << 0)
+#define BODY_PASSWORD    (1u << 1)
+#define BODY_TOO_LONG    (1u << 2)
+#define BODY_BAD_ADDRESS (1u << 3)
+
+// /api/wifi is parsed straight into the worker operation. The static
+// address travels with it and is saved by the worker, so a request the
+// queue turns away changes nothing.
+typedef struct {
+    body_ctx_t base;
+    web_op_t op;
+} wifi_request_t;
+
+static void copy_checked(wifi_request_t *w, char *dst, size_t max_len, const char *value,
+                         int value_len)
+{
+    if (value_len > (int)max_len) w->base.seen |= BODY_TOO_LONG;
+    copy_string(dst, max_len, value);
+}
+
+// Static address field: empty, or a dotted-quad IPv4 address.
+static void copy_address(wifi_request_t *w, char *dst, uint8_t field, const char *value,
+                         int value_len)
+{
+    esp_ip4_addr_t addr;
+    if (value_len > SETTINGS_MAX_IP_LEN ||
+        (value_len > 0 && esp_netif_str_to_ip4(value, &addr) != ESP_OK)) {
+        w->base.seen |= BODY_BAD_ADDRESS;
+        return;
+    }
+    copy_string(dst, SETTINGS_MAX_IP_LEN, value);
+    w->op.wifi.static_fields |= field;
+}
+
+static bool wifi_body_cb(void *arg, json_stream_event_t event, const char *path,
+                         const char *value, int value_len)
+{
+    wifi_request_t *w = arg;
+    if (event == JSON_STREAM_STRING && strcmp(path, "ssid") == 0) {
+        copy_checked(w, w->op.wifi.ssid, SETTINGS_MAX_SSID_LEN, value, value_len);
+        w->base.seen |= BODY_SSID;
+    } else if (event == JSON_STREAM_STRING && strcmp(path, "password") == 0) {
+        copy_checked(w, w->op.wifi.password, SETTINGS_MAX_PASS_LEN, value, value_len);
+        w->base.seen |= BODY_PASSWORD;
+    } else if (is_bool_event(event) && strcmp(path, "static_ip.enabled") == 0) {
+        w->op.wifi.static_enabled = event == JSON_STREAM_TRUE;
+        w->op.wifi.static_fields |= WEB_OP_STATIC_ENABLED;
+    } else if (event == JSON_STREAM_STRING && strcmp(path, "static_ip.ip") == 0) {
+        copy_address(w, w->op.wifi.static_ip, WEB_OP_STATIC_IP, value, value_len);
+    } else if (event == JSON_STREAM_STRING && strcmp(path, "static_ip.gateway") == 0) {
+        copy_address(w, w->op.wifi.static_gateway, WEB_OP_STATIC_GATEWAY, value, value_len);
+    } else if (event == JSON_STREAM_STRING && strcmp(path, "static_ip.netmask") == 0) {
+        copy_address(w, w->op.wifi.static_netmask, WEB_OP_STATIC_NETMASK, value, value_len);
+    } else if (event == JSON_STREAM_STRING && strcmp(path, "static_ip.dns") == 0) {
+        copy_address(w, w->op.wifi.static_dns, WEB_OP_STATIC_DNS, value, value_len);
+    }
+    return true;
+}
+
 // POST /api/wifi — set WiFi credentials and attempt connection
 static esp_err_t wifi_handler(httpd_req_t *req)
 {
-    cJSON *json = read_json_body(req);
-    if (!json) { send_err(req, "Invalid JSON"); return ESP_OK; }
+    wifi_request_t w = {0};
+    w.op.type = WEB_OP_WIFI_CONNECT;
 
-    cJSON *ssid = cJSON_GetObjectItem(json, "ssid");
-    cJSON *password = cJSON_GetObjectItem(json, "password");
-    if (!cJSON_IsString(ssid)) {
-        cJSON_Delete(json);
+    if (!parse_body_or_error(req, wifi_body_cb, &w.base)) return ESP_OK;
+
+    if (!(w.base.seen & BODY_SSID)) {
         send_err(req, "Missing 'ssid' field");
         return ESP_OK;
     }
+    if (w.op.wifi.ssid[0] == '\0' || (w.base.seen & BODY_TOO_LONG)) {
+        send_err(req, "Invalid SSID or password length");
+        return ESP_OK;
+    }
+    // Enabling a static address needs the address, gateway and netmask.
+    if ((w.base.seen & BODY_BAD_ADDRESS) ||
+        (w.op.wifi.static_enabled &&
+         (w.op.wifi.static_ip[0] == '\0' || w.op.wifi.static_gateway[0] == '\0' ||
+          w.op.wifi.static_netmask[0] == '\0'))) {
+        send_err(req, "Static IP fields must be IPv4 addresses");
+        return ESP_OK;
+    }
 
-    const char *pass_str = cJSON_IsString(password) ? password->valuestring : "";
-
-    // Send response before attempting connection (connection will change network)
-    send_ok(req, "Connecting to WiFi...");
-
-    wifi_manager_set_sta_credentials(ssid->valuestring, pass_str);
+    if (!(w.base.seen & BODY_PASSWORD)) {
+        // /api/status doesn't return the password, so the UI omits it to
+        // keep the saved one for the same network.
+        const app_settings_t *cur = settings_acquire();
+        if (strcmp(cur->wifi_ssid, w.op.wifi.ssid) == 0) {
+            strcpy(w.op.wifi.password, cur->wifi_password);
+        }
+        settings_release(cur);
+    }
 
-    cJSON_Delete(json);
+    // The worker saves the credentials and static address and reconnects, which may take this
+    // network away; answer first and let the UI poll the result.
+    send_accepted(req, "Connecting to WiFi...", web_worker_submit(&w.op));
     return ESP_OK;
 }
 
 // POST /api/appearance — update speed and brightness together
 static esp_err_t appearance_handler(httpd_req_t *req)
 {
-    cJSON *json = read_json_body(req);
-    if (!json) { send_err(req, "Invalid JSON"); return ESP_OK; }
-
-    app_settings_t *s = settings_get();
-
-    cJSON *speed = cJSON_GetObjectItem(json, "speed");
-    if (cJSON_IsNumber(speed)) {
-        s->speed = (uint8_t)speed->valueint;
-        scroller_set_speed(s->speed);
-    }
-
-    cJSON *bright = cJSON_GetObjectItem(json, "brightness");
-    if (cJSON_IsNumber(bright)) {
-        s->brightness = (uint8_t)bright->valueint;
-        led_panel_set_brightness(s->brightness);
-    }
+    appearance_request_t a = {0};
+    if (!parse_body_or_error(req, appearance_body_cb, &a.base)) return ESP_OK;
 
-    settings_save(s);
-    cJSON_Delete(json);
-    send_ok(req, "Appearance updated");
+    if (apply_appearance(req, &a)) send_ok(req, "Appearance updated");
     return ESP_OK;
 }
 
-// POST /api/advanced — update advanced settings (panel_cols)
-static esp_err_t advanced_handler(httpd_req_t *req)
-{
-    cJSON *json = read_json_body(req);
-    if (!json) { send_err(req, "Invalid JSON"); return ESP_OK; }
+#define BODY_PANEL_COLS         (1u << 0)
+#define BODY_REFRESH_BUDGET     (1u << 1)
+#define BODY_BACKGROUND_REFRESH (1u << 2)
 
-    app_settings_t *s = settings_get();
+typedef struct {
+    body_ctx_t base;
+    uint8_t panel_cols;
+    uint8_t refresh_budget_s;
+    bool background_refresh;
+} advanced_request_t;
 
-    cJSON *cols = cJSON_GetObjectItem(json, "panel_cols");
-    if (cJSON_IsNumber(cols)) {
-        uint8_t val = (uint8_t)cols->valueint;
+static bool advanced_body_cb(void *arg, json_stream_event_t event, const char *path,
+                             const char *value, int value_len)
+{
+    advanced_request_t *a = arg;
+
+    if (event == JSON_STREAM_NUMBER && strcmp(path, "panel_cols") == 0) {
+        int val = atoi(value);
         if (val == 32 || val == 64 || val == 96 || val == 128) {
-            s->panel_cols = val;
-            led_panel_set_cols(val);
+            a->panel_cols = (uint8_t)val;
+            a->base.seen |= BODY_PANEL_COLS;
+        }
+    } else if (event == JSON_STREAM_NUMBER && strcmp(path, "refresh_budget_s") == 0) {
+        int val = atoi(value);
+        if (val >= SETTINGS_MIN_REFRESH_BUDGET_S && val <= SETTINGS_MAX_REFRESH_BUDGET_S) {
+            a->refresh_budget_s = (uint8_t)val;
+            a->base.seen |= BODY_REFRESH_BUDGET;
         }
+    } else if (is_bool_event(event) && strcmp(path, "background_refresh") == 0) {
+        a->background_refresh = event == JSON_STREAM_TRUE;
+        a->base.seen |= BODY_BACKGROUND_REFRESH;
     }
+    return true;
+}
 
-    settings_save(s);
-    cJSON_Delete(json);
+// POST /api/advanced — update advanced settings (panel_cols)
+static esp_err_t advanced_handler(httpd_req_t *req)
+{
+    advanced_request_t a = {0};
+    if (!parse_body_or_error(req, advanced_body_cb, &a.base)) return ESP_OK;
+
+    app_settings_t *s = begin_edit_or_busy(req);
+    if (!s) return ESP_OK;
+    if (a.base.seen & BODY_PANEL_COLS) s->panel_cols = a.panel_cols;
+    if (a.base.seen & BODY_REFRESH_BUDGET) s->rss_refresh_budget_s = a.refresh_budget_s;
+    if (a.base.seen & BODY_BACKGROUND_REFRESH) s->rss_background_refresh = a.background_refresh;
+    settings_edit_commit(s, SETTINGS_FIELD_PANEL | SETTINGS_FIELD_REFRESH);
     send_ok(req, "Advanced settings updated");
     return ESP_OK;
 }
 
-// POST /api/rss — update RSS settings
-static esp_err_t rss_handler(httpd_req_t *req)
-{
-    cJSON *json = read_json_body(req);
-    if (!json) { send_err(req, "Invalid JSON"); return ESP_OK; }
-
-    app_settings_t *s = settings_get();
-
+// /api/rss fields. Booleans are collected as bits; strings are held in the
+// request until the edit starts.
+static const struct {
+    const char *path;
+    size_t offset;  // bool in app_settings_t
+} rss_bool_fields[] = {
     // Legacy fields (global RSS + NPR URL) remain supported.
-    cJSON *en = cJSON_GetObjectItem(json, "enabled");
-    if (cJSON_IsBool(en)) s->rss_enabled = cJSON_IsTrue(en);
-
-    cJSON *url = cJSON_GetObjectItem(json, "url");
-    if (cJSON_IsString(url)) {
-        strncpy(s->rss_url, url->valuestring, SETTINGS_MAX_URL_LEN);
-        s->rss_url[SETTINGS_MAX_URL_LEN] = '\0';
-    }
-
-    cJSON *npr_en = cJSON_GetObjectItem(json, "npr_enabled");
-    if (cJSON_IsBool(npr_en)) {
-        s->rss_npr_enabled = cJSON_IsTrue(npr_en);
-    }
-
-    cJSON *sports_en = cJSON_GetObjectItem(json, "sports_enabled");
-    if (cJSON_IsBool(sports_en)) {
-        s->rss_sports_enabled = cJSON_IsTrue(sports_en);
-    }
-
-    cJSON *sports_base = cJSON_GetObjectItem(json, "sports_base_url");
-    if (cJSON_IsString(sports_base)) {
-        strncpy(s->rss_sports_base_url, sports_base->valuestring, SETTINGS_MAX_URL_LEN);
-        s->rss_sports_base_url[SETTINGS_MAX_URL_LEN] = '\0';
+    {"enabled",        offsetof(app_settings_t, rss_enabled)},
+    {"npr_enabled",    offsetof(app_settings_t, rss_npr_enabled)},
+    {"sports_enabled", offsetof(app_settings_t, rss_sports_enabled)},
+    {"sports.mlb",     offsetof(app_settings_t, rss_sport_mlb_enabled)},
+    {"sports.nhl",     offsetof(app_settings_t, rss_sport_nhl_enabled)},
+    {"sports.ncaaf",   offsetof(app_settings_t, rss_sport_ncaaf_enabled)},
+    {"sports.nfl",     offsetof(app_settings_t, rss_sport_nfl_enabled)},
+    {"sports.nba",     offsetof(app_settings_t, rss_sport_nba_enabled)},
+    {"sports.big10",   offsetof(app_settings_t, rss_sport_big10_enabled)},
+    {"json.enabled",   offsetof(app_settings_t, rss_json_enabled)},
+};
+
+#define RSS_BOOL_FIELD_COUNT (sizeof(rss_bool_fields) / sizeof(rss_bool_fields[0]))
+
+#define BODY_RSS_URL        (1u << 0)
+#define BODY_RSS_SPORTS_URL (1u << 1)
+#define BODY_RSS_JSON_NAME  (1u << 2)
+#define BODY_RSS_JSON_URL   (1u << 3)
+#define BODY_RSS_JSON_TITLE (1u << 4)
+#define BODY_RSS_JSON_DESC  (1u << 5)
+
+typedef struct {
+    body_ctx_t base;
+    uint16_t bools_seen;  // bit i: rss_bool_fields[i] was sent
+    uint16_t bools_on;
+    char url[SETTINGS_MAX_URL_LEN + 1];
+    char sports_base_url[SETTINGS_MAX_URL_LEN + 1];
+    char json_name[SETTINGS_MAX_RSS_NAME_LEN + 1];
+    char json_url[SETTINGS_MAX_URL_LEN + 1];
+    char json_title_path[SETTINGS_MAX_JSON_PATH_LEN + 1];
+    char json_desc_path[SETTINGS_MAX_JSON_PATH_LEN + 1];
+} rss_request_t;
+
+static bool rss_body_cb(void *arg, json_stream_event_t event, const char *path,
+                        const char *value, int value_len)
+{
+    rss_request_t *r = arg;
+
+    if (is_bool_event(event)) {
+        for (size_t i = 0; i < RSS_BOOL_FIELD_COUNT; i++) {
+            if (strcmp(path, rss_bool_fields[i].path) != 0) continue;
+            r->bools_seen |= 1u << i;
+            if (event == JSON_STREAM_TRUE) {
+                r->bools_on |= 1u << i;
+            } else {
+                r->bools_on &= ~(1u << i);
+            }
+            break;
+        }
+    } else if (event == JSON_STREAM_STRING) {
+        if (strcmp(path, "url") == 0) {
+            copy_string(r->url, SETTINGS_MAX_URL_LEN, value);
+            r->base.seen |= BODY_RSS_URL;
+        } else if (strcmp(path, "sports_base_url") == 0) {
+            copy_string(r->sports_base_url, SETTINGS_MAX_URL_LEN, value);
+            r->base.seen |= BODY_RSS_SPORTS_URL;
+        } else if (strcmp(path, "json.name") == 0) {
+            copy_string(r->json_name, SETTINGS_MAX_RSS_NAME_LEN, value);
+            r->base.seen |= BODY_RSS_JSON_NAME;
+        } else if (strcmp(path, "json.url") == 0) {
+            copy_string(r->json_url, SETTINGS_MAX_URL_LEN, value);
+            r->base.seen |= BODY_RSS_JSON_URL;
+        } else if (strcmp(path, "json.title_path") == 0) {
+            copy_string(r->json_title_path, SETTINGS_MAX_JSON_PATH_LEN, value);
+            r->base.seen |= BODY_RSS_JSON_TITLE;
+        } else if (strcmp(path, "json.desc_path") == 0) {
+            copy_string(r->json_desc_path, SETTINGS_MAX_JSON_PATH_LEN, value);
+            r->base.seen |= BODY_RSS_JSON_DESC;
+        }
     }
+    return true;
+}
 
-    cJSON *sports = cJSON_GetObjectItem(json, "sports");
-    if (cJSON_IsObject(sports)) {
-        cJSON *mlb = cJSON_GetObjectItem(sports, "mlb");
-        if (cJSON_IsBool(mlb)) s->rss_sport_mlb_enabled = cJSON_IsTrue(mlb);
-
-        cJSON *nhl = cJSON_GetObjectItem(sports, "nhl");
-        if (cJSON_IsBool(nhl)) s->rss_sport_nhl_enabled = cJSON_IsTrue(nhl);
-
-        cJSON *ncaaf = cJSON_GetObjectItem(sports, "ncaaf");
-        if (cJSON_IsBool(ncaaf)) s->rss_sport_ncaaf_enabled = cJSON_IsTrue(ncaaf);
-
-        cJSON *nfl = cJSON_GetObjectItem(sports, "nfl");
-        if (cJSON_IsBool(nfl)) s->rss_sport_nfl_enabled = cJSON_IsTrue(nfl);
-
-        cJSON *nba = cJSON_GetObjectItem(sports, "nba");
-        if (cJSON_IsBool(nba)) s->rss_sport_nba_enabled = cJSON_IsTrue(nba);
-
-        cJSON *big10 = cJSON_GetObjectItem(sports, "big10");
-        if (cJSON_IsBool(big10)) s->rss_sport_big10_enabled = cJSON_IsTrue(big10);
+// POST /api/rss — update RSS settings
+static esp_err_t rss_handler(httpd_req_t *req)
+{
+    // About 900 bytes; handlers run one at a time on the httpd task.
+    static rss_request_t r;
+    memset(&r, 0, sizeof(r));
+    if (!parse_body_or_error(req, rss_body_cb, &r.base)) return ESP_OK;
+
+    app_settings_t *s = begin_edit_or_busy(req);
+    if (!s) return ESP_OK;
+    for (size_t i = 0; i < RSS_BOOL_FIELD_COUNT; i++) {
+        if (r.bools_seen & (1u << i)) {
+            *(bool *)((char *)s + rss_bool_fields[i].offset) = (r.bools_on & (1u << i)) != 0;
+        }
     }
+    if (r.base.seen & BODY_RSS_URL) strcpy(s->rss_url, r.url);
+    if (r.base.seen & BODY_RSS_SPORTS_URL) strcpy(s->rss_sports_base_url, r.sports_base_url);
+    if (r.base.seen & BODY_RSS_JSON_NAME) strcpy(s->rss_json_name, r.json_name);
+    if (r.base.seen & BODY_RSS_JSON_URL) strcpy(s->rss_json_url, r.json_url);
+    if (r.base.seen & BODY_RSS_JSON_TITLE) strcpy(s->rss_json_title_path, r.json_title_path);
+    if (r.base.seen & BODY_RSS_JSON_DESC) strcpy(s->rss_json_desc_path, r.json_desc_path);
 
     ESP_LOGI(TAG,
              "RSS save: enabled=%d npr_en=%d npr='%.60s' sports_en=%d base='%.60s' [mlb=%d nhl=%d ncaaf=%d nfl=%d nba=%d big10=%d]",
@@ -431,20 +944,140 @@ static esp_err_t rss_handler(httpd_req_t *req)
              s->rss_sport_nfl_enabled,
              s->rss_sport_nba_enabled,
              s->rss_sport_big10_enabled);
-    settings_save(s);
-    cJSON_Delete(json);
+    ESP_LOGI(TAG, "RSS save: json_en=%d json='%.60s' title='%s' desc='%s'",
+             s->rss_json_enabled, s->rss_json_url,
+             s->rss_json_title_path, s->rss_json_desc_path);
+    settings_edit_commit(s, SETTINGS_FIELD_RSS);
     send_ok(req, "RSS settings updated");
     return ESP_OK;
 }
 
-// POST /api/factory-reset — erase NVS and restart
+// POST /api/factory-reset — erase NVS and restart (on the worker)
 static esp_err_t factory_reset_handler(httpd_req_t *req)
 {
-    send_ok(req, "Factory reset — restarting...");
-    vTaskDelay(pdMS_TO_TICKS(500));
-    nvs_flash_erase();
-    esp_restart();
-    return ESP_OK;  // unreachable
+    web_op_t op = {.type = WEB_OP_FACTORY_RESET};
+    send_accepted(req, "Factory reset — restarting...", web_worker_submit(&op));
+    return ESP_OK;
+}
+
+#define BODY_LOG_TAG   (1u << 0)
+#define BODY_LOG_LEVEL (1u << 1)
+
+typedef struct {
+    body_ctx_t base;
+    char tag[16];
+    char level[12];
+} log_request_t;
+
+static bool log_body_cb(void *arg, json_stream_event_t event, const char *path,
+                        const char *value, int value_len)
+{
+    log_request_t *l = arg;
+    if (event != JSON_STREAM_STRING) return true;
+    if (strcmp(path, "tag") == 0 && value_len < (int)sizeof(l->tag)) {
+        copy_string(l->tag, sizeof(l->tag) - 1, value);
+        l->base.seen |= BODY_LOG_TAG;
+    } else if (strcmp(path, "level") == 0 && value_len < (int)sizeof(l->level)) {
+        copy_string(l->level, sizeof(l->level) - 1, value);
+        l->base.seen |= BODY_LOG_LEVEL;
+    }
+    return true;
+}
+
+// POST /api/log — runtime log level for one tag ("*" for the default)
+static esp_err_t log_level_handler(httpd_req_t *req)
+{
+    log_request_t l = {0};
+    if (!parse_body_or_error(req, log_body_cb, &l.base)) return ESP_OK;
+
+    esp_log_level_t level;
+    if (!(l.base.seen & BODY_LOG_TAG) || !(l.base.seen & BODY_LOG_LEVEL) ||
+        !deferred_log_parse_level(l.level, &level)) {
+        send_err(req, "Expected 'tag' and 'level' (none/error/warn/info/debug/verbose)");
+        return ESP_OK;
+    }
+    if (deferred_log_set_level(l.tag, level) != ESP_OK) {
+        send_err(req, "Invalid tag or too many tags");
+        return ESP_OK;
+    }
+    send_ok(req, "Log level updated");
+    return ESP_OK;
+}
+
+// GET /api/op?id=N — poll an operation returned by a 202 response
+static esp_err_t op_status_handler(httpd_req_t *req)
+{
+    char query[32];
+    char id_str[12];
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) != ESP_OK ||
+        httpd_query_key_value(query, "id", id_str, sizeof(id_str)) != ESP_OK) {
+        send_err(req, "Missing 'id' parameter");
+        return ESP_OK;
+    }
+
+    web_op_status_t st;
+    if (!web_worker_get_status((uint32_t)strtoul(id_str, NULL, 10), &st)) {
+        httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "Unknown operation");
+        return ESP_OK;
+    }
+
+    char resp[160];
+    snprintf(resp, sizeof(resp), "{\"id\":%u,\"state\":\"%s\",\"message\":\"%s\"}",
+             (unsigned)st.id, web_worker_state_name(st.state), st.message);
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_send(req, resp, strlen(resp));
+    return ESP_OK;
+}
+
+// GET /metrics — Prometheus text exposition (see metrics.h)
+static esp_err_t metrics_handler(httpd_req_t *req)
+{
+    char buf[512];
+    httpd_resp_set_type(req, "text/plain; version=0.0.4");
+    const app_settings_t *s = settings_acquire();
+    bool ok = metrics_render(s, buf, sizeof(buf), send_chunk_cb, req);
+    settings_release(s);
+    if (!ok) return ESP_FAIL;
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+// GET /api/trace — refresh/render trace rings as Chrome trace JSON
+static esp_err_t trace_handler(httpd_req_t *req)
+{
+    char buf[512];
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Content-Disposition", "attachment; filename=\"trace.json\"");
+    if (!trace_export(buf, sizeof(buf), send_chunk_cb, req)) return ESP_FAIL;
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+// GET /ws/frames?fps=N — live framebuffer preview (see frame_stream.h).
+// Frames are pushed from the frame_stream task; anything the client sends
+// is read and discarded.
+static esp_err_t ws_frames_handler(httpd_req_t *req)
+{
+    if (req->method == HTTP_GET) {
+        int fps = FRAME_STREAM_DEFAULT_FPS;
+        char query[24];
+        char fps_str[8];
+        if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK &&
+            httpd_query_key_value(query, "fps", fps_str, sizeof(fps_str)) == ESP_OK) {
+            fps = atoi(fps_str);
+        }
+        if (frame_stream_add_client(req->handle, httpd_req_to_sockfd(req), fps) != ESP_OK) {
+            // Handshake is already done; close instead of an HTTP error.
+            httpd_sess_trigger_close(req->handle, httpd_req_to_sockfd(req));
+        }
+        return ESP_OK;
+    }
+
+    uint8_t discard[32];
+    httpd_ws_frame_t frame = {.payload = NULL};
+    esp_err_t err = httpd_ws_recv_frame(req, &frame, 0);
+    if (err != ESP_OK || frame.len == 0) return err;
+    if (frame.len > sizeof(discard)) return ESP_ERR_INVALID_SIZE;  // closes the session
+    frame.payload = discard;
+    return httpd_ws_recv_frame(req, &frame, sizeof(discard));
 }
 
 // Captive portal: redirect all unknown URIs to /
@@ -460,8 +1093,12 @@ void web_server_start(void)
 {
     if (server != NULL) return;
 
+    if (web_worker_init() != ESP_OK) {
+        ESP_LOGE(TAG, "Web worker unavailable; slow requests will be refused");
+    }
+
     httpd_config_t config = HTTPD_DEFAULT_CONFIG();
-    config.max_uri_handlers = 16;
+    config.max_uri_handlers = 20;
     config.uri_match_fn = httpd_uri_match_wildcard;
 
     if (httpd_start(&server, &config) != ESP_OK) {
@@ -473,6 +1110,9 @@ void web_server_start(void)
     httpd_uri_t uris[] = {
         {.uri = "/",               .method = HTTP_GET,  .handler = root_handler},
         {.uri = "/api/status",     .method = HTTP_GET,  .handler = status_handler},
+        {.uri = "/api/op",         .method = HTTP_GET,  .handler = op_status_handler},
+        {.uri = "/metrics",        .method = HTTP_GET,  .handler = metrics_handler},
+        {.uri = "/api/trace",      .method = HTTP_GET,  .handler = trace_handler},
         {.uri = "/api/messages",   .method = HTTP_POST, .handler = messages_handler},
         {.uri = "/api/text",       .method = HTTP_POST, .handler = text_handler},
         {.uri = "/api/color",      .method = HTTP_POST, .handler = color_handler},
@@ -483,6 +1123,9 @@ void web_server_start(void)
         {.uri = "/api/advanced",      .method = HTTP_POST, .handler = advanced_handler},
         {.uri = "/api/rss",           .method = HTTP_POST, .handler = rss_handler},
         {.uri = "/api/factory-reset", .method = HTTP_POST, .handler = factory_reset_handler},
+        {.uri = "/api/log",           .method = HTTP_POST, .handler = log_level_handler},
+        {.uri = "/ws/frames",         .method = HTTP_GET,  .handler = ws_frames_handler,
+         .is_websocket = true},
         {.uri = "/*",                 .method = HTTP_GET,  .handler = captive_redirect_handler},
     };
 
@@ -496,6 +1139,7 @@ void web_server_start(void)
 void web_server_stop(void)
 {
     if (server != NULL) {
+        frame_stream_remove_all();
         httpd_stop(server);
         server = NULL;
     }
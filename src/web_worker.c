@@ -0,0 +1,191 @@
+#include "web_worker.h"
+#include <string.h>
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "nvs_flash.h"
+#include "wifi_manager.h"
+
+static const char *TAG = "web_worker";
+
+typedef struct {
+    uint32_t id;
+    web_op_t op;
+} queued_op_t;
+
+static QueueHandle_t op_queue = NULL;
+static SemaphoreHandle_t status_mutex = NULL;
+static web_op_status_t op_status[WEB_WORKER_OP_SLOTS];
+static uint32_t next_op_id = 1;
+
+static web_op_status_t *status_slot(uint32_t id)
+{
+    return &op_status[id % WEB_WORKER_OP_SLOTS];
+}
+
+static void set_status(uint32_t id, web_op_state_t state, const char *message)
+{
+    xSemaphoreTake(status_mutex, portMAX_DELAY);
+    web_op_status_t *st = status_slot(id);
+    if (st->id == id) {
+        st->state = state;
+        strncpy(st->message, message, sizeof(st->message) - 1);
+        st->message[sizeof(st->message) - 1] = '\0';
+    }
+    xSemaphoreGive(status_mutex);
+}
+
+// Save the request's static address fields; the connection below applies them.
+static bool save_static_ip(const web_op_t *op)
+{
+    uint8_t fields = op->wifi.static_fields;
+    if (fields == 0) return true;
+
+    app_settings_t *s = settings_edit_begin();
+    if (!s) return false;
+    if (fields & WEB_OP_STATIC_ENABLED) s->wifi_static_enabled = op->wifi.static_enabled;
+    if (fields & WEB_OP_STATIC_IP) strcpy(s->wifi_static_ip, op->wifi.static_ip);
+    if (fields & WEB_OP_STATIC_GATEWAY) strcpy(s->wifi_static_gateway, op->wifi.static_gateway);
+    if (fields & WEB_OP_STATIC_NETMASK) strcpy(s->wifi_static_netmask, op->wifi.static_netmask);
+    if (fields & WEB_OP_STATIC_DNS) strcpy(s->wifi_static_dns, op->wifi.static_dns);
+    settings_edit_commit(s, SETTINGS_FIELD_WIFI);
+    return true;
+}
+
+static void run_wifi_connect(uint32_t id, const web_op_t *op)
+{
+    if (!save_static_ip(op)) {
+        set_status(id, WEB_OP_FAILED, "Settings busy, try again");
+        return;
+    }
+    wifi_manager_set_sta_credentials(op->wifi.ssid, op->wifi.password);
+
+    // start_sta_mode() only starts the association; wait for its outcome
+    // (connected, or the fallback to AP mode) so the poller gets a result.
+    TickType_t start = xTaskGetTickCount();
+    while (wifi_manager_get_mode() == WIFI_MGR_MODE_STA_CONNECTING &&
+           (xTaskGetTickCount() - start) < pdMS_TO_TICKS(WEB_WORKER_WIFI_TIMEOUT_MS)) {
+        vTaskDelay(pdMS_TO_TICKS(250));
+    }
+
+    char msg[64];
+    switch (wifi_manager_get_mode()) {
+    case WIFI_MGR_MODE_STA:
+        snprintf(msg, sizeof(msg), "Connected, IP %s", wifi_manager_get_ip());
+        set_status(id, WEB_OP_DONE, msg);
+        break;
+    case WIFI_MGR_MODE_STA_CONNECTING:
+        set_status(id, WEB_OP_FAILED, "Still connecting");
+        break;
+    default:
+        set_status(id, WEB_OP_FAILED, "Connection failed, back in AP mode");
+        break;
+    }
+}
+
+static void run_factory_reset(uint32_t id)
+{
+    set_status(id, WEB_OP_RUNNING, "Restarting");
+    // Let the 202 and any status poll go out before the radio drops.
+    vTaskDelay(pdMS_TO_TICKS(500));
+    nvs_flash_erase();
+    esp_restart();
+}
+
+static void web_worker_task(void *arg)
+{
+    (void)arg;
+    queued_op_t item;
+    while (1) {
+        if (xQueueReceive(op_queue, &item, portMAX_DELAY) != pdTRUE) continue;
+
+        set_status(item.id, WEB_OP_RUNNING, "Running");
+        switch (item.op.type) {
+        case WEB_OP_WIFI_CONNECT:
+            ESP_LOGI(TAG, "op %u: WiFi connect to '%s'", (unsigned)item.id, item.op.wifi.ssid);
+            run_wifi_connect(item.id, &item.op);
+            break;
+        case WEB_OP_FACTORY_RESET:
+            ESP_LOGI(TAG, "op %u: factory reset", (unsigned)item.id);
+            run_factory_reset(item.id);
+            break;
+        default:
+            set_status(item.id, WEB_OP_FAILED, "Unknown operation");
+            break;
+        }
+    }
+}
+
+esp_err_t web_worker_init(void)
+{
+    if (op_queue) return ESP_OK;
+
+    status_mutex = xSemaphoreCreateMutex();
+    op_queue = xQueueCreate(WEB_WORKER_QUEUE_LEN, sizeof(queued_op_t));
+    if (!status_mutex || !op_queue) {
+        ESP_LOGE(TAG, "Failed to create worker queue");
+        return ESP_ERR_NO_MEM;
+    }
+
+    if (xTaskCreate(web_worker_task, "web_worker", 4096, NULL, 4, NULL) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to start worker task");
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+uint32_t web_worker_submit(const web_op_t *op)
+{
+    if (!op_queue || !op) return 0;
+
+    queued_op_t item;
+    item.op = *op;
+
+    xSemaphoreTake(status_mutex, portMAX_DELAY);
+    item.id = next_op_id++;
+    if (next_op_id == 0) next_op_id = 1;
+
+    web_op_status_t *st = status_slot(item.id);
+    web_op_status_t previous = *st;
+    memset(st, 0, sizeof(*st));
+    st->id = item.id;
+    st->type = op->type;
+    st->state = WEB_OP_PENDING;
+    strcpy(st->message, "Queued");
+
+    if (xQueueSend(op_queue, &item, 0) != pdTRUE) {
+        *st = previous;
+        xSemaphoreGive(status_mutex);
+        ESP_LOGW(TAG, "Worker queue full, op dropped");
+        return 0;
+    }
+    xSemaphoreGive(status_mutex);
+    return item.id;
+}
+
+bool web_worker_get_status(uint32_t id, web_op_status_t *out)
+{
+    if (!status_mutex || id == 0 || !out) return false;
+
+    xSemaphoreTake(status_mutex, portMAX_DELAY);
+    const web_op_status_t *st = status_slot(id);
+    bool found = st->id == id;
+    if (found) *out = *st;
+    xSemaphoreGive(status_mutex);
+    return found;
+}
+
+const char *web_worker_state_name(web_op_state_t state)
+{
+    switch (state) {
+    case WEB_OP_PENDING: return "pending";
+    case WEB_OP_RUNNING: return "running";
+    case WEB_OP_DONE:    return "done";
+    case WEB_OP_FAILED:  return "failed";
+    default:             return "unknown";
+    }
+}
@@ -8,10 +8,15 @@
 #include "esp_wifi.h"
 #include "esp_event.h"
 #include "esp_log.h"
+#include "esp_mac.h"
 #include "esp_netif.h"
+#include "esp_timer.h"
+#include "nvs.h"
 #include "lwip/sockets.h"
 #include "settings.h"
 #include "text_scroller.h"
+#include "metrics.h"
+#include "trace.h"
 
 static const char *TAG = "wifi_mgr";
 
@@ -19,6 +24,19 @@ static const char *TAG = "wifi_mgr";
 #define AP_MAX_CONN     4
 #define STA_MAX_RETRY   5
 #define STA_CONNECT_TIMEOUT_MS 15000
+#define RADIO_ON_TIMEOUT_MS    5000
+// A join to a known BSSID/channel normally completes well under a second.
+#define FAST_CONNECT_TIMEOUT_MS 1500
+
+#define FAST_CONNECT_NVS_NAMESPACE "mancave"
+#define FAST_CONNECT_NVS_KEY       "wifi_fast"
+
+// Last AP we associated with, so radio_on can skip the channel scan.
+typedef struct {
+    uint8_t bssid[6];
+    uint8_t channel;
+    uint8_t valid;
+} fast_connect_t;
 
 static wifi_mgr_mode_t current_mode = WIFI_MGR_MODE_NONE;
 static char current_ip[16] = "0.0.0.0";
@@ -29,6 +47,9 @@ static EventGroupHandle_t wifi_event_group;
 static TaskHandle_t dns_task_handle = NULL;
 static esp_netif_t *sta_netif = NULL;
 static esp_netif_t *ap_netif = NULL;
+static fast_connect_t fast_connect = {0};
+static fast_connect_t last_association = {0};
+static wifi_reconnect_stats_t reconnect_stats = {0};
 
 #define WIFI_CONNECTED_BIT BIT0
 #define WIFI_FAIL_BIT      BIT1
@@ -37,6 +58,107 @@ static void start_ap_mode(void);
 static void start_sta_mode(const char *ssid, const char *password);
 static void dns_server_task(void *param);
 
+static void fast_connect_load(void)
+{
+    nvs_handle_t handle;
+    if (nvs_open(FAST_CONNECT_NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) return;
+
+    fast_connect_t stored = {0};
+    size_t len = sizeof(stored);
+    if (nvs_get_blob(handle, FAST_CONNECT_NVS_KEY, &stored, &len) == ESP_OK &&
+        len == sizeof(stored) && stored.valid && stored.channel > 0) {
+        fast_connect = stored;
+        ESP_LOGI(TAG, "Cached AP " MACSTR " on channel %u", MAC2STR(fast_connect.bssid),
+                 (unsigned)fast_connect.channel);
+    }
+    nvs_close(handle);
+}
+
+static void fast_connect_forget(void)
+{
+    memset(&fast_connect, 0, sizeof(fast_connect));
+    nvs_handle_t handle;
+    if (nvs_open(FAST_CONNECT_NVS_NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) return;
+    nvs_erase_key(handle, FAST_CONNECT_NVS_KEY);
+    nvs_commit(handle);
+    nvs_close(handle);
+}
+
+// Persist the AP from the association that just succeeded. Flash is only
+// written when the AP or channel actually changed.
+static void fast_connect_remember(void)
+{
+    if (!last_association.valid) return;
+    if (fast_connect.valid && memcmp(&fast_connect, &last_association, sizeof(fast_connect)) == 0) {
+        return;
+    }
+
+    fast_connect = last_association;
+    nvs_handle_t handle;
+    if (nvs_open(FAST_CONNECT_NVS_NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) return;
+    if (nvs_set_blob(handle, FAST_CONNECT_NVS_KEY, &fast_connect, sizeof(fast_connect)) == ESP_OK &&
+        nvs_commit(handle) == ESP_OK) {
+        metrics_add(METRIC_NVS_WRITE_BYTES, sizeof(fast_connect));
+    }
+    nvs_close(handle);
+    ESP_LOGI(TAG, "Saved AP " MACSTR " on channel %u for fast reconnect",
+             MAC2STR(fast_connect.bssid), (unsigned)fast_connect.channel);
+}
+
+// Target the cached AP directly, or go back to a normal scan for the SSID.
+static void apply_sta_target(bool use_cached_ap)
+{
+    wifi_config_t wifi_config;
+    if (esp_wifi_get_config(WIFI_IF_STA, &wifi_config) != ESP_OK) return;
+
+    if (use_cached_ap) {
+        wifi_config.sta.bssid_set = true;
+        memcpy(wifi_config.sta.bssid, fast_connect.bssid, sizeof(wifi_config.sta.bssid));
+        wifi_config.sta.channel = fast_connect.channel;
+    } else {
+        wifi_config.sta.bssid_set = false;
+        memset(wifi_config.sta.bssid, 0, sizeof(wifi_config.sta.bssid));
+        wifi_config.sta.channel = 0;
+    }
+    wifi_config.sta.scan_method = WIFI_FAST_SCAN;
+    esp_wifi_set_config(WIFI_IF_STA, &wifi_config);
+}
+
+// Static address from settings, or DHCP. With DHCP, lwIP asks for the last
+// lease first (CONFIG_LWIP_DHCP_RESTORE_LAST_IP) instead of a full discover.
+static void apply_ip_config(void)
+{
+    const app_settings_t *settings = settings_acquire();
+    if (!settings->wifi_static_enabled) {
+        esp_netif_dhcpc_start(sta_netif);
+        settings_release(settings);
+        return;
+    }
+
+    esp_netif_ip_info_t ip_info = {0};
+    if (esp_netif_str_to_ip4(settings->wifi_static_ip, &ip_info.ip) != ESP_OK ||
+        esp_netif_str_to_ip4(settings->wifi_static_gateway, &ip_info.gw) != ESP_OK ||
+        esp_netif_str_to_ip4(settings->wifi_static_netmask, &ip_info.netmask) != ESP_OK) {
+        ESP_LOGW(TAG, "Static IP settings invalid, using DHCP");
+        esp_netif_dhcpc_start(sta_netif);
+        settings_release(settings);
+        return;
+    }
+
+    esp_netif_dhcpc_stop(sta_netif);
+    esp_netif_set_ip_info(sta_netif, &ip_info);
+
+    esp_netif_dns_info_t dns = {0};
+    const char *dns_str = settings->wifi_static_dns[0] ? settings->wifi_static_dns
+                                                      : settings->wifi_static_gateway;
+    if (esp_netif_str_to_ip4(dns_str, &dns.ip.u_addr.ip4) == ESP_OK) {
+        dns.ip.type = ESP_IPADDR_TYPE_V4;
+        esp_netif_set_dns_info(sta_netif, ESP_NETIF_DNS_MAIN, &dns);
+    }
+    ESP_LOGI(TAG, "Using static IP %s", settings->wifi_static_ip);
+    settings_release(settings);
+}
+
 static void wifi_event_handler(void *arg, esp_event_base_t event_base,
                                int32_t event_id, void *event_data)
 {
@@ -45,6 +167,13 @@ static void wifi_event_handler(void *arg, esp_event_base_t event_base,
         case WIFI_EVENT_STA_START:
             esp_wifi_connect();
             break;
+        case WIFI_EVENT_STA_CONNECTED: {
+            wifi_event_sta_connected_t *event = (wifi_event_sta_connected_t *)event_data;
+            memcpy(last_association.bssid, event->bssid, sizeof(last_association.bssid));
+            last_association.channel = event->channel;
+            last_association.valid = 1;
+            break;
+        }
         case WIFI_EVENT_STA_DISCONNECTED:
             if (radio_cycling) {
                 // During radio cycling, allow one retry then give up
@@ -145,6 +274,7 @@ static void start_sta_mode(const char *ssid, const char *password)
 
     esp_wifi_set_mode(WIFI_MODE_STA);
     esp_wifi_set_config(WIFI_IF_STA, &wifi_config);
+    apply_ip_config();
     esp_wifi_start();
 
     // Wait for connection or failure
@@ -154,6 +284,7 @@ static void start_sta_mode(const char *ssid, const char *password)
                                            pdMS_TO_TICKS(STA_CONNECT_TIMEOUT_MS));
 
     if (bits & WIFI_CONNECTED_BIT) {
+        fast_connect_remember();
         ESP_LOGI(TAG, "STA connected to %s — suspending WiFi for display", ssid);
         // Suppress disconnect-handler retries during intentional shutdown
         radio_cycling = true;
@@ -257,14 +388,21 @@ void wifi_manager_init(void)
                                         &wifi_event_handler, NULL, NULL);
     esp_event_handler_instance_register(IP_EVENT, IP_EVENT_STA_GOT_IP,
                                         &wifi_event_handler, NULL, NULL);
+
+    fast_connect_load();
 }
 
 void wifi_manager_start(void)
 {
-    app_settings_t *settings = settings_get();
-
-    if (strlen(settings->wifi_ssid) > 0) {
-        start_sta_mode(settings->wifi_ssid, settings->wifi_password);
+    char ssid[SETTINGS_MAX_SSID_LEN + 1];
+    char password[SETTINGS_MAX_PASS_LEN + 1];
+    const app_settings_t *settings = settings_acquire();
+    memcpy(ssid, settings->wifi_ssid, sizeof(ssid));
+    memcpy(password, settings->wifi_password, sizeof(password));
+    settings_release(settings);
+
+    if (strlen(ssid) > 0) {
+        start_sta_mode(ssid, password);
     } else {
         start_ap_mode();
     }
@@ -287,48 +425,121 @@ const char *wifi_manager_get_ssid(void)
 
 void wifi_manager_set_sta_credentials(const char *ssid, const char *password)
 {
-    app_settings_t *settings = settings_get();
-    strncpy(settings->wifi_ssid, ssid, SETTINGS_MAX_SSID_LEN);
-    settings->wifi_ssid[SETTINGS_MAX_SSID_LEN] = '\0';
-    strncpy(settings->wifi_password, password, SETTINGS_MAX_PASS_LEN);
-    settings->wifi_password[SETTINGS_MAX_PASS_LEN] = '\0';
-    settings_save(settings);
+    app_settings_t *settings = settings_edit_begin();
+    if (settings) {
+        strncpy(settings->wifi_ssid, ssid, SETTINGS_MAX_SSID_LEN);
+        settings->wifi_ssid[SETTINGS_MAX_SSID_LEN] = '\0';
+        strncpy(settings->wifi_password, password, SETTINGS_MAX_PASS_LEN);
+        settings->wifi_password[SETTINGS_MAX_PASS_LEN] = '\0';
+        settings_edit_commit(settings, SETTINGS_FIELD_WIFI);
+        // Persist now; the reconnect below may end in AP mode or a power cycle.
+        settings_flush();
+    }
+
+    // The cached AP belongs to the old network.
+    fast_connect_forget();
 
     // Attempt STA connection with new credentials
     start_sta_mode(ssid, password);
 }
 
-bool wifi_manager_radio_on(void)
+static void radio_stop_quietly(void)
+{
+    // Suppress disconnect-handler retries during intentional shutdown
+    radio_cycling = true;
+    sta_retry_count = 1;
+    esp_wifi_stop();
+    vTaskDelay(pdMS_TO_TICKS(50)); // let pending disconnect events drain
+    radio_cycling = false;
+}
+
+static bool radio_connect(uint32_t timeout_ms)
 {
-    if (current_mode != WIFI_MGR_MODE_STA) return false;
     radio_cycling = true;
     sta_retry_count = 0;
     xEventGroupClearBits(wifi_event_group, WIFI_CONNECTED_BIT | WIFI_FAIL_BIT);
     esp_wifi_start();
 
-    // Wait up to 5 seconds for reconnection
     EventBits_t bits = xEventGroupWaitBits(wifi_event_group,
                                            WIFI_CONNECTED_BIT | WIFI_FAIL_BIT,
                                            pdTRUE, pdFALSE,
-                                           pdMS_TO_TICKS(5000));
+                                           pdMS_TO_TICKS(timeout_ms));
     radio_cycling = false;
+    return (bits & WIFI_CONNECTED_BIT) != 0;
+}
 
-    if (bits & WIFI_CONNECTED_BIT) {
-        ESP_LOGI(TAG, "Radio on — WiFi connected");
+static void record_reconnect(bool connected, bool fast_path, uint32_t elapsed_ms)
+{
+    if (!connected) {
+        reconnect_stats.failures++;
+        return;
+    }
+    reconnect_stats.last_ms = elapsed_ms;
+    reconnect_stats.last_fast_path = fast_path;
+    if (elapsed_ms > reconnect_stats.max_ms) reconnect_stats.max_ms = elapsed_ms;
+    if (reconnect_stats.count == 0 || elapsed_ms < reconnect_stats.min_ms) {
+        reconnect_stats.min_ms = elapsed_ms;
+    }
+    reconnect_stats.total_ms += elapsed_ms;
+    reconnect_stats.count++;
+    if (fast_path) reconnect_stats.fast_path_count++;
+}
+
+bool wifi_manager_radio_on(void)
+{
+    if (current_mode != WIFI_MGR_MODE_STA) return false;
+
+    trace_begin(TRACE_CAT_REFRESH, "wifi_radio_on", 0);
+    int64_t start_us = esp_timer_get_time();
+    bool fast_path = fast_connect.valid;
+    bool connected = false;
+
+    if (fast_path) {
+        trace_begin(TRACE_CAT_REFRESH, "wifi_fast_connect", fast_connect.channel);
+        apply_sta_target(true);
+        connected = radio_connect(FAST_CONNECT_TIMEOUT_MS);
+        trace_end(TRACE_CAT_REFRESH, "wifi_fast_connect", connected);
+        if (!connected) {
+            // AP moved channel or was replaced; scan normally and relearn it.
+            ESP_LOGW(TAG, "Fast reconnect to cached AP failed, scanning");
+            radio_stop_quietly();
+            fast_connect.valid = 0;
+            fast_path = false;
+        }
+    }
+    if (!connected) {
+        trace_begin(TRACE_CAT_REFRESH, "wifi_scan_connect", 0);
+        apply_sta_target(false);
+        connected = radio_connect(RADIO_ON_TIMEOUT_MS);
+        trace_end(TRACE_CAT_REFRESH, "wifi_scan_connect", connected);
+    }
+
+    uint32_t elapsed_us = (uint32_t)(esp_timer_get_time() - start_us);
+    uint32_t elapsed_ms = elapsed_us / 1000;
+    record_reconnect(connected, fast_path, elapsed_ms);
+    metrics_observe_wifi_reconnect(elapsed_us, connected);
+    trace_end(TRACE_CAT_REFRESH, "wifi_radio_on", connected);
+
+    if (connected) {
+        ESP_LOGI(TAG, "Radio on — WiFi connected in %u ms%s", (unsigned)elapsed_ms,
+                 fast_path ? " (cached AP)" : "");
+        fast_connect_remember();
         return true;
     }
 
-    ESP_LOGW(TAG, "Radio on — connection failed");
+    ESP_LOGW(TAG, "Radio on — connection failed after %u ms", (unsigned)elapsed_ms);
     esp_wifi_stop();
     return false;
 }
 
+void wifi_manager_get_reconnect_stats(wifi_reconnect_stats_t *out)
+{
+    if (out) *out = reconnect_stats;
+}
+
 void wifi_manager_radio_off(void)
 {
-    // Suppress disconnect-handler retries during intentional shutdown
-    radio_cycling = true;
-    sta_retry_count = 1;
-    esp_wifi_stop();
-    vTaskDelay(pdMS_TO_TICKS(50)); // let pending disconnect events drain
-    radio_cycling = false;
+    trace_begin(TRACE_CAT_REFRESH, "wifi_radio_off", 0);
+    radio_stop_quietly();
+    trace_end(TRACE_CAT_REFRESH, "wifi_radio_off", 0);
 }